@@ -15,37 +15,1472 @@
 // specific language governing permissions and limitations
 // under the License.
 
+// mremap() is only declared when _GNU_SOURCE is defined
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "atomic_internal.h"
 #include "nanoarrow.h"
 
-void* ArrowMalloc(int64_t size) { return malloc(size); }
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#if defined(__GNUC__) && !defined(_WIN32)
+#include <pthread.h>
+#define NANOARROW_HAVE_POOL_ALLOCATOR 1
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define NANOARROW_HAVE_MMAP_ALLOCATOR 1
+#endif
+
+// When an allocator has been set using ArrowMallocSetAllocator(), each
+// allocation is prefixed with a header recording its size because
+// ArrowBufferAllocator callbacks need the size to reallocate or free.
+// The header is 16 bytes so that the returned pointer keeps the alignment
+// of the underlying allocation.
+static struct ArrowBufferAllocator* ArrowMallocAllocator = NULL;
+
+#define NANOARROW_MALLOC_HEADER_BYTES 16
+
+void ArrowMallocSetAllocator(struct ArrowBufferAllocator* allocator) {
+  ArrowMallocAllocator = allocator;
+}
+
+void* ArrowMalloc(int64_t size) {
+  struct ArrowBufferAllocator* allocator = ArrowMallocAllocator;
+  if (allocator == NULL) {
+    return malloc(size);
+  }
+
+  if (size < 0 || size > (INT64_MAX - NANOARROW_MALLOC_HEADER_BYTES)) {
+    return NULL;
+  }
+
+  uint8_t* out = allocator->allocate(allocator, size + NANOARROW_MALLOC_HEADER_BYTES);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  memcpy(out, &size, sizeof(int64_t));
+  return out + NANOARROW_MALLOC_HEADER_BYTES;
+}
+
+void* ArrowRealloc(void* ptr, int64_t size) {
+  struct ArrowBufferAllocator* allocator = ArrowMallocAllocator;
+  if (allocator == NULL) {
+    return realloc(ptr, size);
+  }
+
+  if (ptr == NULL) {
+    return ArrowMalloc(size);
+  }
+
+  if (size < 0 || size > (INT64_MAX - NANOARROW_MALLOC_HEADER_BYTES)) {
+    return NULL;
+  }
+
+  uint8_t* base = (uint8_t*)ptr - NANOARROW_MALLOC_HEADER_BYTES;
+  int64_t old_size;
+  memcpy(&old_size, base, sizeof(int64_t));
+
+  uint8_t* out =
+      allocator->reallocate(allocator, base, old_size + NANOARROW_MALLOC_HEADER_BYTES,
+                            size + NANOARROW_MALLOC_HEADER_BYTES);
+  if (out == NULL) {
+    return NULL;
+  }
 
-void* ArrowRealloc(void* ptr, int64_t size) { return realloc(ptr, size); }
+  memcpy(out, &size, sizeof(int64_t));
+  return out + NANOARROW_MALLOC_HEADER_BYTES;
+}
+
+void ArrowFree(void* ptr) {
+  struct ArrowBufferAllocator* allocator = ArrowMallocAllocator;
+  if (allocator == NULL) {
+    free(ptr);
+    return;
+  }
+
+  if (ptr == NULL) {
+    return;
+  }
+
+  uint8_t* base = (uint8_t*)ptr - NANOARROW_MALLOC_HEADER_BYTES;
+  int64_t size;
+  memcpy(&size, base, sizeof(int64_t));
+  allocator->free(allocator, base, size + NANOARROW_MALLOC_HEADER_BYTES);
+}
 
-void ArrowFree(void* ptr) { free(ptr); }
+// The allocators defined here use the system allocator directly (rather than
+// malloc() and friends) so that any of them can be passed to
+// ArrowMallocSetAllocator().
 
 static uint8_t* ArrowBufferAllocatorMallocAllocate(struct ArrowBufferAllocator* allocator,
                                                    int64_t size) {
-  return ArrowMalloc(size);
+  return (uint8_t*)malloc(size);
 }
 
 static uint8_t* ArrowBufferAllocatorMallocReallocate(
     struct ArrowBufferAllocator* allocator, uint8_t* ptr, int64_t old_size,
     int64_t new_size) {
-  return ArrowRealloc(ptr, new_size);
+  return (uint8_t*)realloc(ptr, new_size);
 }
 
 static void ArrowBufferAllocatorMallocFree(struct ArrowBufferAllocator* allocator,
                                            uint8_t* ptr, int64_t size) {
-  ArrowFree(ptr);
+  free(ptr);
+}
+
+static uint8_t* ArrowBufferAllocatorMallocAllocateZeroed(
+    struct ArrowBufferAllocator* allocator, int64_t size) {
+  return (uint8_t*)calloc(1, size);
 }
 
 static struct ArrowBufferAllocator ArrowBufferAllocatorMalloc = {
     &ArrowBufferAllocatorMallocAllocate, &ArrowBufferAllocatorMallocReallocate,
-    &ArrowBufferAllocatorMallocFree, NULL};
+    &ArrowBufferAllocatorMallocFree, NULL, &ArrowBufferAllocatorMallocAllocateZeroed};
 
 struct ArrowBufferAllocator* ArrowBufferAllocatorDefault() {
   return &ArrowBufferAllocatorMalloc;
 }
+
+// Allocators that wrap another allocator use this to forward zeroed
+// allocations, which zeroes the memory here if the wrapped allocator cannot
+// provide zeroed memory itself
+static uint8_t* ArrowBufferAllocatorAllocateZeroed(struct ArrowBufferAllocator* allocator,
+                                                   int64_t size) {
+  if (allocator->allocate_zeroed != NULL) {
+    return allocator->allocate_zeroed(allocator, size);
+  }
+
+  uint8_t* out = allocator->allocate(allocator, size);
+  if (out != NULL && size > 0) {
+    memset(out, 0, size);
+  }
+
+  return out;
+}
+
+// The arena hands out memory from a linked list of chunks. New allocations
+// are carved from the head chunk; allocations too big for a standard chunk
+// get their own chunk that is linked in after the head so that the remaining
+// space in the head chunk is not lost.
+struct ArrowBufferAllocatorArenaChunk {
+  struct ArrowBufferAllocatorArenaChunk* next;
+  int64_t capacity;
+  int64_t used;
+  int64_t padding;
+};
+
+struct ArrowBufferAllocatorArenaPrivate {
+  struct ArrowBufferAllocatorArenaChunk* chunks;
+  int64_t chunk_size;
+
+  // The most recent allocation (and the chunk it lives in), which can be
+  // grown, shrunk, or freed in place.
+  uint8_t* last_ptr;
+  struct ArrowBufferAllocatorArenaChunk* last_chunk;
+};
+
+#define NANOARROW_ARENA_ALIGNMENT 16
+
+static int64_t ArrowBufferAllocatorArenaAlign(int64_t size) {
+  return (size + NANOARROW_ARENA_ALIGNMENT - 1) &
+         ~((int64_t)NANOARROW_ARENA_ALIGNMENT - 1);
+}
+
+static uint8_t* ArrowBufferAllocatorArenaChunkData(
+    struct ArrowBufferAllocatorArenaChunk* chunk) {
+  return (uint8_t*)chunk + sizeof(struct ArrowBufferAllocatorArenaChunk);
+}
+
+static struct ArrowBufferAllocatorArenaChunk* ArrowBufferAllocatorArenaNewChunk(
+    int64_t capacity) {
+  struct ArrowBufferAllocatorArenaChunk* chunk =
+      (struct ArrowBufferAllocatorArenaChunk*)malloc(
+          sizeof(struct ArrowBufferAllocatorArenaChunk) + capacity);
+  if (chunk == NULL) {
+    return NULL;
+  }
+
+  chunk->next = NULL;
+  chunk->capacity = capacity;
+  chunk->used = 0;
+  return chunk;
+}
+
+static uint8_t* ArrowBufferAllocatorArenaAllocate(struct ArrowBufferAllocator* allocator,
+                                                  int64_t size) {
+  struct ArrowBufferAllocatorArenaPrivate* private_data =
+      (struct ArrowBufferAllocatorArenaPrivate*)allocator->private_data;
+
+  int64_t max_size = INT64_MAX - (int64_t)sizeof(struct ArrowBufferAllocatorArenaChunk) -
+                     NANOARROW_ARENA_ALIGNMENT;
+  if (size <= 0 || size > max_size) {
+    return NULL;
+  }
+
+  int64_t aligned_size = ArrowBufferAllocatorArenaAlign(size);
+  struct ArrowBufferAllocatorArenaChunk* chunk = private_data->chunks;
+
+  if (chunk == NULL || (chunk->capacity - chunk->used) < aligned_size) {
+    if (aligned_size > private_data->chunk_size) {
+      chunk = ArrowBufferAllocatorArenaNewChunk(aligned_size);
+      if (chunk == NULL) {
+        return NULL;
+      }
+
+      if (private_data->chunks == NULL) {
+        private_data->chunks = chunk;
+      } else {
+        chunk->next = private_data->chunks->next;
+        private_data->chunks->next = chunk;
+      }
+    } else {
+      chunk = ArrowBufferAllocatorArenaNewChunk(private_data->chunk_size);
+      if (chunk == NULL) {
+        return NULL;
+      }
+
+      chunk->next = private_data->chunks;
+      private_data->chunks = chunk;
+    }
+  }
+
+  uint8_t* out = ArrowBufferAllocatorArenaChunkData(chunk) + chunk->used;
+  chunk->used += aligned_size;
+  private_data->last_ptr = out;
+  private_data->last_chunk = chunk;
+  return out;
+}
+
+static uint8_t* ArrowBufferAllocatorArenaReallocate(
+    struct ArrowBufferAllocator* allocator, uint8_t* ptr, int64_t old_size,
+    int64_t new_size) {
+  struct ArrowBufferAllocatorArenaPrivate* private_data =
+      (struct ArrowBufferAllocatorArenaPrivate*)allocator->private_data;
+
+  if (ptr == NULL) {
+    return ArrowBufferAllocatorArenaAllocate(allocator, new_size);
+  }
+
+  if (new_size <= 0) {
+    allocator->free(allocator, ptr, old_size);
+    return NULL;
+  }
+
+  // Grow or shrink the most recent allocation in place if it fits
+  struct ArrowBufferAllocatorArenaChunk* last_chunk = NULL;
+  int64_t last_offset = 0;
+  if (ptr == private_data->last_ptr) {
+    last_chunk = private_data->last_chunk;
+    last_offset = ptr - ArrowBufferAllocatorArenaChunkData(last_chunk);
+    if (new_size <= (last_chunk->capacity - last_offset)) {
+      last_chunk->used = last_offset + ArrowBufferAllocatorArenaAlign(new_size);
+      return ptr;
+    }
+  }
+
+  uint8_t* out = ArrowBufferAllocatorArenaAllocate(allocator, new_size);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  memcpy(out, ptr, old_size < new_size ? old_size : new_size);
+
+  // The new block never lives in the same chunk as the old one here, so
+  // the space used by the old block can be handed out again.
+  if (last_chunk != NULL) {
+    last_chunk->used = last_offset;
+  }
+
+  return out;
+}
+
+static void ArrowBufferAllocatorArenaFree(struct ArrowBufferAllocator* allocator,
+                                          uint8_t* ptr, int64_t size) {
+  struct ArrowBufferAllocatorArenaPrivate* private_data =
+      (struct ArrowBufferAllocatorArenaPrivate*)allocator->private_data;
+
+  // Only the most recent allocation can be reclaimed before a reset
+  if (ptr != NULL && ptr == private_data->last_ptr) {
+    private_data->last_chunk->used =
+        ptr - ArrowBufferAllocatorArenaChunkData(private_data->last_chunk);
+    private_data->last_ptr = NULL;
+    private_data->last_chunk = NULL;
+  }
+}
+
+ArrowErrorCode ArrowBufferAllocatorArenaInit(struct ArrowBufferAllocator* allocator,
+                                             int64_t chunk_size) {
+  if (chunk_size <= 0) {
+    return EINVAL;
+  }
+
+  struct ArrowBufferAllocatorArenaPrivate* private_data =
+      (struct ArrowBufferAllocatorArenaPrivate*)malloc(
+          sizeof(struct ArrowBufferAllocatorArenaPrivate));
+  if (private_data == NULL) {
+    return ENOMEM;
+  }
+
+  private_data->chunks = NULL;
+  private_data->chunk_size = ArrowBufferAllocatorArenaAlign(chunk_size);
+  private_data->last_ptr = NULL;
+  private_data->last_chunk = NULL;
+
+  allocator->allocate = &ArrowBufferAllocatorArenaAllocate;
+  allocator->reallocate = &ArrowBufferAllocatorArenaReallocate;
+  allocator->free = &ArrowBufferAllocatorArenaFree;
+  allocator->allocate_zeroed = NULL;
+  allocator->private_data = private_data;
+  return NANOARROW_OK;
+}
+
+void ArrowBufferAllocatorArenaReset(struct ArrowBufferAllocator* allocator) {
+  struct ArrowBufferAllocatorArenaPrivate* private_data =
+      (struct ArrowBufferAllocatorArenaPrivate*)allocator->private_data;
+
+  struct ArrowBufferAllocatorArenaChunk* chunk = private_data->chunks;
+  if (chunk == NULL) {
+    return;
+  }
+
+  // Keep the head chunk so that steady-state batch building does not have
+  // to go back to the system allocator
+  struct ArrowBufferAllocatorArenaChunk* next = chunk->next;
+  chunk->next = NULL;
+  chunk->used = 0;
+
+  while (next != NULL) {
+    chunk = next;
+    next = chunk->next;
+    free(chunk);
+  }
+
+  private_data->last_ptr = NULL;
+  private_data->last_chunk = NULL;
+}
+
+void ArrowBufferAllocatorArenaRelease(struct ArrowBufferAllocator* allocator) {
+  struct ArrowBufferAllocatorArenaPrivate* private_data =
+      (struct ArrowBufferAllocatorArenaPrivate*)allocator->private_data;
+  if (private_data == NULL) {
+    return;
+  }
+
+  struct ArrowBufferAllocatorArenaChunk* chunk = private_data->chunks;
+  while (chunk != NULL) {
+    struct ArrowBufferAllocatorArenaChunk* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+
+  free(private_data);
+  allocator->private_data = NULL;
+}
+
+// A deallocator wraps memory that was allocated elsewhere. Growing a buffer
+// that uses a deallocator copies its contents into memory from the default
+// allocator, gives the original memory back to its owner, and replaces the
+// buffer's allocator (which ArrowBuffer holds by value) with the default
+// allocator.
+static uint8_t* ArrowBufferDeallocatorAllocate(struct ArrowBufferAllocator* allocator,
+                                               int64_t size) {
+  return NULL;
+}
+
+static uint8_t* ArrowBufferDeallocatorReallocate(struct ArrowBufferAllocator* allocator,
+                                                 uint8_t* ptr, int64_t old_size,
+                                                 int64_t new_size) {
+  struct ArrowBufferAllocator* default_allocator = ArrowBufferAllocatorDefault();
+
+  uint8_t* out = NULL;
+  if (new_size > 0) {
+    out = default_allocator->allocate(default_allocator, new_size);
+    if (out == NULL) {
+      return NULL;
+    }
+
+    if (ptr != NULL) {
+      memcpy(out, ptr, old_size < new_size ? old_size : new_size);
+    }
+  }
+
+  if (ptr != NULL) {
+    allocator->free(allocator, ptr, old_size);
+  }
+
+  *allocator = *default_allocator;
+  return out;
+}
+
+struct ArrowBufferAllocator ArrowBufferDeallocator(
+    void (*custom_free)(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                        int64_t size),
+    void* private_data) {
+  struct ArrowBufferAllocator allocator;
+  allocator.allocate = &ArrowBufferDeallocatorAllocate;
+  allocator.reallocate = &ArrowBufferDeallocatorReallocate;
+  allocator.free = custom_free;
+  allocator.allocate_zeroed = NULL;
+  allocator.private_data = private_data;
+  return allocator;
+}
+
+// The recycling allocator keeps freed blocks from a base allocator in buckets
+// keyed by the floor of the log2 of their capacity and hands them out again
+// for the next allocation that fits. Each block is prefixed by a header
+// recording its real capacity so that a recycled block that is bigger than
+// requested can be grown in place later, which is what lets a buffer built
+// for a batch of the same shape as the previous one avoid reallocating
+// entirely.
+#define NANOARROW_RECYCLING_N_BUCKETS 64
+
+struct ArrowBufferAllocatorRecyclingBlock {
+  int64_t capacity;
+  struct ArrowBufferAllocatorRecyclingBlock* next;
+};
+
+#define NANOARROW_RECYCLING_HEADER_BYTES \
+  ((int64_t)sizeof(struct ArrowBufferAllocatorRecyclingBlock))
+
+struct ArrowBufferAllocatorRecyclingPrivate {
+  struct ArrowBufferAllocator* base;
+  int64_t max_cached_bytes;
+  struct ArrowBufferAllocatorRecyclingBlock* buckets[NANOARROW_RECYCLING_N_BUCKETS];
+  struct ArrowBufferAllocatorRecyclingStats stats;
+};
+
+static int ArrowBufferAllocatorRecyclingBucket(int64_t capacity) {
+  int bucket = 0;
+  while (capacity > 1) {
+    capacity >>= 1;
+    bucket++;
+  }
+
+  return bucket;
+}
+
+static struct ArrowBufferAllocatorRecyclingBlock* ArrowBufferAllocatorRecyclingHeader(
+    uint8_t* ptr) {
+  return (struct ArrowBufferAllocatorRecyclingBlock*)ptr - 1;
+}
+
+static uint8_t* ArrowBufferAllocatorRecyclingData(
+    struct ArrowBufferAllocatorRecyclingBlock* block) {
+  return (uint8_t*)(block + 1);
+}
+
+// Remove and return the smallest cached block that can hold size bytes
+static struct ArrowBufferAllocatorRecyclingBlock* ArrowBufferAllocatorRecyclingTake(
+    struct ArrowBufferAllocatorRecyclingPrivate* private_data, int64_t size) {
+  int bucket = ArrowBufferAllocatorRecyclingBucket(size);
+
+  // Blocks in the bucket of size may or may not be big enough
+  struct ArrowBufferAllocatorRecyclingBlock** link = &private_data->buckets[bucket];
+  while (*link != NULL) {
+    if ((*link)->capacity >= size) {
+      struct ArrowBufferAllocatorRecyclingBlock* block = *link;
+      *link = block->next;
+      private_data->stats.bytes_cached -= block->capacity;
+      return block;
+    }
+
+    link = &(*link)->next;
+  }
+
+  // ...but every block in a bigger bucket is
+  for (int i = bucket + 1; i < NANOARROW_RECYCLING_N_BUCKETS; i++) {
+    struct ArrowBufferAllocatorRecyclingBlock* block = private_data->buckets[i];
+    if (block != NULL) {
+      private_data->buckets[i] = block->next;
+      private_data->stats.bytes_cached -= block->capacity;
+      return block;
+    }
+  }
+
+  return NULL;
+}
+
+static void ArrowBufferAllocatorRecyclingGive(
+    struct ArrowBufferAllocatorRecyclingPrivate* private_data,
+    struct ArrowBufferAllocatorRecyclingBlock* block) {
+  int64_t cache_remaining =
+      private_data->max_cached_bytes - private_data->stats.bytes_cached;
+  if (block->capacity > cache_remaining) {
+    private_data->base->free(private_data->base, (uint8_t*)block,
+                             block->capacity + NANOARROW_RECYCLING_HEADER_BYTES);
+    return;
+  }
+
+  int bucket = ArrowBufferAllocatorRecyclingBucket(block->capacity);
+  block->next = private_data->buckets[bucket];
+  private_data->buckets[bucket] = block;
+  private_data->stats.bytes_cached += block->capacity;
+}
+
+static uint8_t* ArrowBufferAllocatorRecyclingAllocate(
+    struct ArrowBufferAllocator* allocator, int64_t size) {
+  struct ArrowBufferAllocatorRecyclingPrivate* private_data =
+      (struct ArrowBufferAllocatorRecyclingPrivate*)allocator->private_data;
+
+  if (size <= 0 || size > (INT64_MAX - NANOARROW_RECYCLING_HEADER_BYTES)) {
+    return NULL;
+  }
+
+  struct ArrowBufferAllocatorRecyclingBlock* block =
+      ArrowBufferAllocatorRecyclingTake(private_data, size);
+  if (block != NULL) {
+    private_data->stats.n_hits++;
+    return ArrowBufferAllocatorRecyclingData(block);
+  }
+
+  private_data->stats.n_misses++;
+  block = (struct ArrowBufferAllocatorRecyclingBlock*)private_data->base->allocate(
+      private_data->base, size + NANOARROW_RECYCLING_HEADER_BYTES);
+  if (block == NULL) {
+    return NULL;
+  }
+
+  block->capacity = size;
+  return ArrowBufferAllocatorRecyclingData(block);
+}
+
+static uint8_t* ArrowBufferAllocatorRecyclingAllocateZeroed(
+    struct ArrowBufferAllocator* allocator, int64_t size) {
+  struct ArrowBufferAllocatorRecyclingPrivate* private_data =
+      (struct ArrowBufferAllocatorRecyclingPrivate*)allocator->private_data;
+
+  if (size <= 0 || size > (INT64_MAX - NANOARROW_RECYCLING_HEADER_BYTES)) {
+    return NULL;
+  }
+
+  // A recycled block holds whatever its previous owner wrote to it
+  struct ArrowBufferAllocatorRecyclingBlock* block =
+      ArrowBufferAllocatorRecyclingTake(private_data, size);
+  if (block != NULL) {
+    private_data->stats.n_hits++;
+    memset(ArrowBufferAllocatorRecyclingData(block), 0, size);
+    return ArrowBufferAllocatorRecyclingData(block);
+  }
+
+  private_data->stats.n_misses++;
+  block = (struct ArrowBufferAllocatorRecyclingBlock*)ArrowBufferAllocatorAllocateZeroed(
+      private_data->base, size + NANOARROW_RECYCLING_HEADER_BYTES);
+  if (block == NULL) {
+    return NULL;
+  }
+
+  block->capacity = size;
+  return ArrowBufferAllocatorRecyclingData(block);
+}
+
+static void ArrowBufferAllocatorRecyclingFree(struct ArrowBufferAllocator* allocator,
+                                              uint8_t* ptr, int64_t size) {
+  struct ArrowBufferAllocatorRecyclingPrivate* private_data =
+      (struct ArrowBufferAllocatorRecyclingPrivate*)allocator->private_data;
+
+  if (ptr != NULL) {
+    ArrowBufferAllocatorRecyclingGive(private_data,
+                                      ArrowBufferAllocatorRecyclingHeader(ptr));
+  }
+}
+
+static uint8_t* ArrowBufferAllocatorRecyclingReallocate(
+    struct ArrowBufferAllocator* allocator, uint8_t* ptr, int64_t old_size,
+    int64_t new_size) {
+  struct ArrowBufferAllocatorRecyclingPrivate* private_data =
+      (struct ArrowBufferAllocatorRecyclingPrivate*)allocator->private_data;
+
+  if (ptr == NULL) {
+    return ArrowBufferAllocatorRecyclingAllocate(allocator, new_size);
+  }
+
+  if (new_size <= 0) {
+    ArrowBufferAllocatorRecyclingFree(allocator, ptr, old_size);
+    return NULL;
+  }
+
+  // Growing (or shrinking) within the real capacity of the block. This is
+  // neither a hit nor a miss because no cached block was involved.
+  struct ArrowBufferAllocatorRecyclingBlock* block =
+      ArrowBufferAllocatorRecyclingHeader(ptr);
+  if (new_size <= block->capacity) {
+    return ptr;
+  }
+
+  // Moving to a cached block that is big enough
+  struct ArrowBufferAllocatorRecyclingBlock* cached =
+      ArrowBufferAllocatorRecyclingTake(private_data, new_size);
+  if (cached != NULL) {
+    private_data->stats.n_hits++;
+    memcpy(ArrowBufferAllocatorRecyclingData(cached), ptr, old_size);
+    ArrowBufferAllocatorRecyclingGive(private_data, block);
+    return ArrowBufferAllocatorRecyclingData(cached);
+  }
+
+  if (new_size > (INT64_MAX - NANOARROW_RECYCLING_HEADER_BYTES)) {
+    return NULL;
+  }
+
+  private_data->stats.n_misses++;
+  struct ArrowBufferAllocatorRecyclingBlock* out =
+      (struct ArrowBufferAllocatorRecyclingBlock*)private_data->base->reallocate(
+          private_data->base, (uint8_t*)block,
+          block->capacity + NANOARROW_RECYCLING_HEADER_BYTES,
+          new_size + NANOARROW_RECYCLING_HEADER_BYTES);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  out->capacity = new_size;
+  return ArrowBufferAllocatorRecyclingData(out);
+}
+
+ArrowErrorCode ArrowBufferAllocatorRecyclingInit(struct ArrowBufferAllocator* allocator,
+                                                 struct ArrowBufferAllocator* base,
+                                                 int64_t max_cached_bytes) {
+  if (max_cached_bytes < 0) {
+    return EINVAL;
+  }
+
+  struct ArrowBufferAllocatorRecyclingPrivate* private_data =
+      (struct ArrowBufferAllocatorRecyclingPrivate*)malloc(
+          sizeof(struct ArrowBufferAllocatorRecyclingPrivate));
+  if (private_data == NULL) {
+    return ENOMEM;
+  }
+
+  memset(private_data, 0, sizeof(struct ArrowBufferAllocatorRecyclingPrivate));
+  private_data->base = base;
+  private_data->max_cached_bytes = max_cached_bytes;
+
+  allocator->allocate = &ArrowBufferAllocatorRecyclingAllocate;
+  allocator->reallocate = &ArrowBufferAllocatorRecyclingReallocate;
+  allocator->free = &ArrowBufferAllocatorRecyclingFree;
+  allocator->allocate_zeroed = &ArrowBufferAllocatorRecyclingAllocateZeroed;
+  allocator->private_data = private_data;
+  return NANOARROW_OK;
+}
+
+void ArrowBufferAllocatorRecyclingGetStats(
+    struct ArrowBufferAllocator* allocator,
+    struct ArrowBufferAllocatorRecyclingStats* stats_out) {
+  struct ArrowBufferAllocatorRecyclingPrivate* private_data =
+      (struct ArrowBufferAllocatorRecyclingPrivate*)allocator->private_data;
+  *stats_out = private_data->stats;
+}
+
+void ArrowBufferAllocatorRecyclingRelease(struct ArrowBufferAllocator* allocator) {
+  struct ArrowBufferAllocatorRecyclingPrivate* private_data =
+      (struct ArrowBufferAllocatorRecyclingPrivate*)allocator->private_data;
+  if (private_data == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < NANOARROW_RECYCLING_N_BUCKETS; i++) {
+    struct ArrowBufferAllocatorRecyclingBlock* block = private_data->buckets[i];
+    while (block != NULL) {
+      struct ArrowBufferAllocatorRecyclingBlock* next = block->next;
+      private_data->base->free(private_data->base, (uint8_t*)block,
+                               block->capacity + NANOARROW_RECYCLING_HEADER_BYTES);
+      block = next;
+    }
+  }
+
+  free(private_data);
+  allocator->private_data = NULL;
+}
+
+// The statistics allocator forwards to another allocator and records what
+// passes through it. Counters are updated atomically so that the allocator can
+// be shared by buffers built on different threads.
+struct ArrowBufferAllocatorStatsPrivate {
+  struct ArrowBufferAllocator* base;
+  struct ArrowBufferAllocatorStats stats;
+};
+
+static void ArrowBufferAllocatorStatsRecordAllocate(
+    struct ArrowBufferAllocatorStatsPrivate* private_data, int64_t size) {
+  ArrowAtomicAdd(&private_data->stats.n_allocations, 1);
+  int64_t bytes_allocated = ArrowAtomicAdd(&private_data->stats.bytes_allocated, size);
+  ArrowAtomicMax(&private_data->stats.peak_bytes_allocated, bytes_allocated);
+}
+
+static void ArrowBufferAllocatorStatsRecordFree(
+    struct ArrowBufferAllocatorStatsPrivate* private_data, int64_t size) {
+  ArrowAtomicAdd(&private_data->stats.n_frees, 1);
+  ArrowAtomicAdd(&private_data->stats.bytes_allocated, -size);
+}
+
+static uint8_t* ArrowBufferAllocatorStatsAllocate(struct ArrowBufferAllocator* allocator,
+                                                  int64_t size) {
+  struct ArrowBufferAllocatorStatsPrivate* private_data =
+      (struct ArrowBufferAllocatorStatsPrivate*)allocator->private_data;
+
+  uint8_t* out = private_data->base->allocate(private_data->base, size);
+  if (out != NULL) {
+    ArrowBufferAllocatorStatsRecordAllocate(private_data, size);
+  }
+
+  return out;
+}
+
+static uint8_t* ArrowBufferAllocatorStatsAllocateZeroed(
+    struct ArrowBufferAllocator* allocator, int64_t size) {
+  struct ArrowBufferAllocatorStatsPrivate* private_data =
+      (struct ArrowBufferAllocatorStatsPrivate*)allocator->private_data;
+
+  uint8_t* out = ArrowBufferAllocatorAllocateZeroed(private_data->base, size);
+  if (out != NULL) {
+    ArrowBufferAllocatorStatsRecordAllocate(private_data, size);
+  }
+
+  return out;
+}
+
+static uint8_t* ArrowBufferAllocatorStatsReallocate(
+    struct ArrowBufferAllocator* allocator, uint8_t* ptr, int64_t old_size,
+    int64_t new_size) {
+  struct ArrowBufferAllocatorStatsPrivate* private_data =
+      (struct ArrowBufferAllocatorStatsPrivate*)allocator->private_data;
+
+  uint8_t* out =
+      private_data->base->reallocate(private_data->base, ptr, old_size, new_size);
+
+  // Reallocating from or to nothing is really an allocation or a free
+  if (ptr == NULL) {
+    if (out != NULL) {
+      ArrowBufferAllocatorStatsRecordAllocate(private_data, new_size);
+    }
+  } else if (new_size <= 0) {
+    ArrowBufferAllocatorStatsRecordFree(private_data, old_size);
+  } else if (out != NULL) {
+    ArrowAtomicAdd(&private_data->stats.n_reallocations, 1);
+    int64_t bytes_allocated =
+        ArrowAtomicAdd(&private_data->stats.bytes_allocated, new_size - old_size);
+    ArrowAtomicMax(&private_data->stats.peak_bytes_allocated, bytes_allocated);
+
+    // A reallocation that moved the buffer copied its contents
+    if (out != ptr) {
+      ArrowAtomicAdd(&private_data->stats.bytes_copied,
+                     old_size < new_size ? old_size : new_size);
+    }
+  }
+
+  return out;
+}
+
+static void ArrowBufferAllocatorStatsFree(struct ArrowBufferAllocator* allocator,
+                                          uint8_t* ptr, int64_t size) {
+  struct ArrowBufferAllocatorStatsPrivate* private_data =
+      (struct ArrowBufferAllocatorStatsPrivate*)allocator->private_data;
+
+  private_data->base->free(private_data->base, ptr, size);
+  if (ptr != NULL) {
+    ArrowBufferAllocatorStatsRecordFree(private_data, size);
+  }
+}
+
+ArrowErrorCode ArrowBufferAllocatorStatsInit(struct ArrowBufferAllocator* allocator,
+                                             struct ArrowBufferAllocator* base) {
+  struct ArrowBufferAllocatorStatsPrivate* private_data =
+      (struct ArrowBufferAllocatorStatsPrivate*)malloc(
+          sizeof(struct ArrowBufferAllocatorStatsPrivate));
+  if (private_data == NULL) {
+    return ENOMEM;
+  }
+
+  private_data->base = base;
+  memset(&private_data->stats, 0, sizeof(struct ArrowBufferAllocatorStats));
+
+  allocator->allocate = &ArrowBufferAllocatorStatsAllocate;
+  allocator->reallocate = &ArrowBufferAllocatorStatsReallocate;
+  allocator->free = &ArrowBufferAllocatorStatsFree;
+  allocator->allocate_zeroed = &ArrowBufferAllocatorStatsAllocateZeroed;
+  allocator->private_data = private_data;
+  return NANOARROW_OK;
+}
+
+void ArrowBufferAllocatorStatsGet(struct ArrowBufferAllocator* allocator,
+                                  struct ArrowBufferAllocatorStats* stats_out) {
+  struct ArrowBufferAllocatorStatsPrivate* private_data =
+      (struct ArrowBufferAllocatorStatsPrivate*)allocator->private_data;
+  struct ArrowBufferAllocatorStats* stats = &private_data->stats;
+
+  stats_out->bytes_allocated = ArrowAtomicLoad(&stats->bytes_allocated);
+  stats_out->peak_bytes_allocated = ArrowAtomicLoad(&stats->peak_bytes_allocated);
+  stats_out->n_allocations = ArrowAtomicLoad(&stats->n_allocations);
+  stats_out->n_reallocations = ArrowAtomicLoad(&stats->n_reallocations);
+  stats_out->n_frees = ArrowAtomicLoad(&stats->n_frees);
+  stats_out->bytes_copied = ArrowAtomicLoad(&stats->bytes_copied);
+}
+
+void ArrowBufferAllocatorStatsRelease(struct ArrowBufferAllocator* allocator) {
+  if (allocator->private_data != NULL) {
+    free(allocator->private_data);
+    allocator->private_data = NULL;
+  }
+}
+
+// The limit allocator forwards to another allocator but first reserves the
+// requested bytes against a shared budget using a compare-and-swap loop so that
+// concurrent allocations can never overshoot the hard limit.
+struct ArrowBufferAllocatorLimitPrivate {
+  struct ArrowBufferAllocator* base;
+  int64_t soft_limit;
+  int64_t hard_limit;
+  void (*soft_limit_callback)(struct ArrowBufferAllocator* allocator,
+                              int64_t bytes_allocated, void* callback_data);
+  void* callback_data;
+  int64_t bytes_allocated;
+};
+
+// Returns non-zero if delta bytes could be added to the budget
+static int ArrowBufferAllocatorLimitReserve(struct ArrowBufferAllocator* allocator,
+                                            int64_t delta) {
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)allocator->private_data;
+
+  int64_t current = ArrowAtomicLoad(&private_data->bytes_allocated);
+  int64_t desired;
+  do {
+    if (delta > 0 && delta > (private_data->hard_limit - current)) {
+      return 0;
+    }
+
+    desired = current + delta;
+  } while (
+      !ArrowAtomicCompareExchange(&private_data->bytes_allocated, &current, desired));
+
+  // Only the allocation that crosses the soft limit triggers the callback
+  if (current <= private_data->soft_limit && desired > private_data->soft_limit &&
+      private_data->soft_limit_callback != NULL) {
+    private_data->soft_limit_callback(allocator, desired, private_data->callback_data);
+  }
+
+  return 1;
+}
+
+static void ArrowBufferAllocatorLimitUnreserve(struct ArrowBufferAllocator* allocator,
+                                               int64_t delta) {
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)allocator->private_data;
+  ArrowAtomicAdd(&private_data->bytes_allocated, -delta);
+}
+
+static uint8_t* ArrowBufferAllocatorLimitAllocate(struct ArrowBufferAllocator* allocator,
+                                                  int64_t size) {
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)allocator->private_data;
+
+  if (size <= 0 || !ArrowBufferAllocatorLimitReserve(allocator, size)) {
+    return NULL;
+  }
+
+  uint8_t* out = private_data->base->allocate(private_data->base, size);
+  if (out == NULL) {
+    ArrowBufferAllocatorLimitUnreserve(allocator, size);
+  }
+
+  return out;
+}
+
+static uint8_t* ArrowBufferAllocatorLimitAllocateZeroed(
+    struct ArrowBufferAllocator* allocator, int64_t size) {
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)allocator->private_data;
+
+  if (size <= 0 || !ArrowBufferAllocatorLimitReserve(allocator, size)) {
+    return NULL;
+  }
+
+  uint8_t* out = ArrowBufferAllocatorAllocateZeroed(private_data->base, size);
+  if (out == NULL) {
+    ArrowBufferAllocatorLimitUnreserve(allocator, size);
+  }
+
+  return out;
+}
+
+static uint8_t* ArrowBufferAllocatorLimitReallocate(
+    struct ArrowBufferAllocator* allocator, uint8_t* ptr, int64_t old_size,
+    int64_t new_size) {
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)allocator->private_data;
+
+  if (ptr == NULL) {
+    old_size = 0;
+  }
+
+  if (new_size < 0) {
+    new_size = 0;
+  }
+
+  // Growth is reserved up front; shrinking is accounted for once it happened
+  int64_t delta = new_size - old_size;
+  if (delta > 0 && !ArrowBufferAllocatorLimitReserve(allocator, delta)) {
+    return NULL;
+  }
+
+  uint8_t* out =
+      private_data->base->reallocate(private_data->base, ptr, old_size, new_size);
+
+  if (out == NULL && new_size > 0) {
+    // A failed reallocation leaves the original allocation untouched
+    if (delta > 0) {
+      ArrowBufferAllocatorLimitUnreserve(allocator, delta);
+    }
+  } else if (delta < 0) {
+    ArrowBufferAllocatorLimitUnreserve(allocator, -delta);
+  }
+
+  return out;
+}
+
+static void ArrowBufferAllocatorLimitFree(struct ArrowBufferAllocator* allocator,
+                                          uint8_t* ptr, int64_t size) {
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)allocator->private_data;
+
+  private_data->base->free(private_data->base, ptr, size);
+  if (ptr != NULL) {
+    ArrowBufferAllocatorLimitUnreserve(allocator, size);
+  }
+}
+
+ArrowErrorCode ArrowBufferAllocatorLimitInit(
+    struct ArrowBufferAllocator* allocator, struct ArrowBufferAllocator* base,
+    int64_t soft_limit, int64_t hard_limit,
+    void (*soft_limit_callback)(struct ArrowBufferAllocator* allocator,
+                                int64_t bytes_allocated, void* callback_data),
+    void* callback_data) {
+  if (soft_limit < 0 || hard_limit < 0) {
+    return EINVAL;
+  }
+
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)malloc(
+          sizeof(struct ArrowBufferAllocatorLimitPrivate));
+  if (private_data == NULL) {
+    return ENOMEM;
+  }
+
+  private_data->base = base;
+  private_data->soft_limit = soft_limit;
+  private_data->hard_limit = hard_limit;
+  private_data->soft_limit_callback = soft_limit_callback;
+  private_data->callback_data = callback_data;
+  private_data->bytes_allocated = 0;
+
+  allocator->allocate = &ArrowBufferAllocatorLimitAllocate;
+  allocator->reallocate = &ArrowBufferAllocatorLimitReallocate;
+  allocator->free = &ArrowBufferAllocatorLimitFree;
+  allocator->allocate_zeroed = &ArrowBufferAllocatorLimitAllocateZeroed;
+  allocator->private_data = private_data;
+  return NANOARROW_OK;
+}
+
+int64_t ArrowBufferAllocatorLimitBytesAllocated(struct ArrowBufferAllocator* allocator) {
+  struct ArrowBufferAllocatorLimitPrivate* private_data =
+      (struct ArrowBufferAllocatorLimitPrivate*)allocator->private_data;
+  return ArrowAtomicLoad(&private_data->bytes_allocated);
+}
+
+void ArrowBufferAllocatorLimitRelease(struct ArrowBufferAllocator* allocator) {
+  if (allocator->private_data != NULL) {
+    free(allocator->private_data);
+    allocator->private_data = NULL;
+  }
+}
+
+// The aligned allocator rounds every allocation up to a multiple of
+// NANOARROW_ALIGNED_ALLOCATOR_BYTES and places it on an address that is a
+// multiple of NANOARROW_ALIGNED_ALLOCATOR_BYTES as recommended by the Arrow
+// columnar format.
+#define NANOARROW_ALIGNED_ALLOCATOR_BYTES 64
+
+static int64_t ArrowBufferAllocatorAlignedPadding(int64_t size) {
+  return (size + NANOARROW_ALIGNED_ALLOCATOR_BYTES - 1) &
+         ~((int64_t)NANOARROW_ALIGNED_ALLOCATOR_BYTES - 1);
+}
+
+static uint8_t* ArrowBufferAllocatorAlignedAllocate(
+    struct ArrowBufferAllocator* allocator, int64_t size) {
+  if (size <= 0 || size > (INT64_MAX - NANOARROW_ALIGNED_ALLOCATOR_BYTES)) {
+    return NULL;
+  }
+
+  int64_t padded_size = ArrowBufferAllocatorAlignedPadding(size);
+
+#if defined(_WIN32)
+  return (uint8_t*)_aligned_malloc(padded_size, NANOARROW_ALIGNED_ALLOCATOR_BYTES);
+#else
+  void* out;
+  if (posix_memalign(&out, NANOARROW_ALIGNED_ALLOCATOR_BYTES, padded_size) != 0) {
+    return NULL;
+  }
+
+  return (uint8_t*)out;
+#endif
+}
+
+static void ArrowBufferAllocatorAlignedFree(struct ArrowBufferAllocator* allocator,
+                                            uint8_t* ptr, int64_t size) {
+#if defined(_WIN32)
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+static uint8_t* ArrowBufferAllocatorAlignedReallocate(
+    struct ArrowBufferAllocator* allocator, uint8_t* ptr, int64_t old_size,
+    int64_t new_size) {
+  if (ptr == NULL) {
+    return ArrowBufferAllocatorAlignedAllocate(allocator, new_size);
+  }
+
+  if (new_size <= 0) {
+    ArrowBufferAllocatorAlignedFree(allocator, ptr, old_size);
+    return NULL;
+  }
+
+  // The padding may already be big enough to hold new_size
+  if (new_size <= (INT64_MAX - NANOARROW_ALIGNED_ALLOCATOR_BYTES) &&
+      ArrowBufferAllocatorAlignedPadding(new_size) ==
+          ArrowBufferAllocatorAlignedPadding(old_size)) {
+    return ptr;
+  }
+
+  // realloc() does not preserve alignment, so always allocate and copy
+  uint8_t* out = ArrowBufferAllocatorAlignedAllocate(allocator, new_size);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  memcpy(out, ptr, old_size < new_size ? old_size : new_size);
+  ArrowBufferAllocatorAlignedFree(allocator, ptr, old_size);
+  return out;
+}
+
+static struct ArrowBufferAllocator ArrowBufferAllocatorAlignedInstance = {
+    &ArrowBufferAllocatorAlignedAllocate, &ArrowBufferAllocatorAlignedReallocate,
+    &ArrowBufferAllocatorAlignedFree, NULL, NULL};
+
+struct ArrowBufferAllocator* ArrowBufferAllocatorAligned() {
+  return &ArrowBufferAllocatorAlignedInstance;
+}
+
+// The mmap allocator maps allocations of at least NANOARROW_MMAP_THRESHOLD_BYTES
+// directly from the operating system (asking for transparent huge pages where
+// supported) and grows them with mremap() where available so that growing a
+// large buffer remaps pages instead of copying them. Smaller allocations use
+// malloc(). Whether an allocation is mapped is a function of its size,
+// which the ArrowBufferAllocator interface passes to every callback.
+#if defined(NANOARROW_HAVE_MMAP_ALLOCATOR)
+
+#ifndef NANOARROW_MMAP_THRESHOLD_BYTES
+#define NANOARROW_MMAP_THRESHOLD_BYTES ((int64_t)2 << 20)
+#endif
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+static int64_t ArrowBufferAllocatorMmapLength(int64_t size) {
+  int64_t page_size = sysconf(_SC_PAGESIZE);
+  return (size + page_size - 1) & ~(page_size - 1);
+}
+
+static uint8_t* ArrowBufferAllocatorMmapMap(int64_t size) {
+  if (size > (INT64_MAX / 2)) {
+    return NULL;
+  }
+
+  int64_t length = ArrowBufferAllocatorMmapLength(size);
+  void* out = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                   -1, 0);
+  if (out == MAP_FAILED) {
+    return NULL;
+  }
+
+#if defined(MADV_HUGEPAGE)
+  madvise(out, length, MADV_HUGEPAGE);
+#endif
+
+  return (uint8_t*)out;
+}
+
+static uint8_t* ArrowBufferAllocatorMmapAllocate(struct ArrowBufferAllocator* allocator,
+                                                 int64_t size) {
+  if (size < NANOARROW_MMAP_THRESHOLD_BYTES) {
+    return (uint8_t*)malloc(size);
+  }
+
+  return ArrowBufferAllocatorMmapMap(size);
+}
+
+// Freshly mapped pages are always zero
+static uint8_t* ArrowBufferAllocatorMmapAllocateZeroed(
+    struct ArrowBufferAllocator* allocator, int64_t size) {
+  if (size < NANOARROW_MMAP_THRESHOLD_BYTES) {
+    return (uint8_t*)calloc(1, size);
+  }
+
+  return ArrowBufferAllocatorMmapMap(size);
+}
+
+static void ArrowBufferAllocatorMmapFree(struct ArrowBufferAllocator* allocator,
+                                         uint8_t* ptr, int64_t size) {
+  if (size < NANOARROW_MMAP_THRESHOLD_BYTES) {
+    free(ptr);
+  } else if (ptr != NULL) {
+    munmap(ptr, ArrowBufferAllocatorMmapLength(size));
+  }
+}
+
+static uint8_t* ArrowBufferAllocatorMmapReallocate(struct ArrowBufferAllocator* allocator,
+                                                   uint8_t* ptr, int64_t old_size,
+                                                   int64_t new_size) {
+  if (ptr == NULL) {
+    return ArrowBufferAllocatorMmapAllocate(allocator, new_size);
+  }
+
+  int old_mapped = old_size >= NANOARROW_MMAP_THRESHOLD_BYTES;
+  int new_mapped = new_size >= NANOARROW_MMAP_THRESHOLD_BYTES;
+
+  if (!old_mapped && !new_mapped) {
+    return (uint8_t*)realloc(ptr, new_size);
+  }
+
+  if (old_mapped && new_mapped) {
+    if (new_size > (INT64_MAX / 2)) {
+      return NULL;
+    }
+
+    int64_t old_length = ArrowBufferAllocatorMmapLength(old_size);
+    int64_t new_length = ArrowBufferAllocatorMmapLength(new_size);
+    if (old_length == new_length) {
+      return ptr;
+    }
+
+#if defined(MREMAP_MAYMOVE)
+    void* out = mremap(ptr, old_length, new_length, MREMAP_MAYMOVE);
+    if (out == MAP_FAILED) {
+      return NULL;
+    }
+
+#if defined(MADV_HUGEPAGE)
+    madvise(out, new_length, MADV_HUGEPAGE);
+#endif
+
+    return (uint8_t*)out;
+#endif
+  }
+
+  // Crossing the threshold (or no mremap()) requires a copy
+  uint8_t* out = ArrowBufferAllocatorMmapAllocate(allocator, new_size);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  memcpy(out, ptr, old_size < new_size ? old_size : new_size);
+  ArrowBufferAllocatorMmapFree(allocator, ptr, old_size);
+  return out;
+}
+
+static struct ArrowBufferAllocator ArrowBufferAllocatorMmapInstance = {
+    &ArrowBufferAllocatorMmapAllocate, &ArrowBufferAllocatorMmapReallocate,
+    &ArrowBufferAllocatorMmapFree, NULL, &ArrowBufferAllocatorMmapAllocateZeroed};
+
+struct ArrowBufferAllocator* ArrowBufferAllocatorMmap() {
+  return &ArrowBufferAllocatorMmapInstance;
+}
+
+#else
+
+struct ArrowBufferAllocator* ArrowBufferAllocatorMmap() {
+  return ArrowBufferAllocatorDefault();
+}
+
+#endif
+
+// The pool allocator rounds requests up to a power-of-two size class and keeps
+// freed blocks on per-thread free lists so that most allocations never touch
+// the system allocator or any lock. When a thread caches more than
+// NANOARROW_POOL_THREAD_CACHE_BYTES, the least recently freed half of its cache
+// is moved to a global pool (which is protected by a mutex); blocks beyond
+// NANOARROW_POOL_GLOBAL_CACHE_BYTES are returned to the system. Requests larger
+// than the biggest size class go straight to the system allocator.
+#if defined(NANOARROW_HAVE_POOL_ALLOCATOR)
+
+#ifndef NANOARROW_POOL_THREAD_CACHE_BYTES
+#define NANOARROW_POOL_THREAD_CACHE_BYTES ((int64_t)4 << 20)
+#endif
+
+#ifndef NANOARROW_POOL_GLOBAL_CACHE_BYTES
+#define NANOARROW_POOL_GLOBAL_CACHE_BYTES ((int64_t)64 << 20)
+#endif
+
+#define NANOARROW_POOL_MIN_SHIFT 6
+#define NANOARROW_POOL_MAX_SHIFT 20
+#define NANOARROW_POOL_N_CLASSES (NANOARROW_POOL_MAX_SHIFT - NANOARROW_POOL_MIN_SHIFT + 1)
+
+// Number of blocks moved from the global pool to a thread cache at once
+#define NANOARROW_POOL_REFILL_BLOCKS 8
+
+// Free blocks are linked through their first bytes
+struct ArrowBufferAllocatorPoolBlock {
+  struct ArrowBufferAllocatorPoolBlock* next;
+};
+
+struct ArrowBufferAllocatorPoolCache {
+  struct ArrowBufferAllocatorPoolBlock* blocks[NANOARROW_POOL_N_CLASSES];
+  int64_t n_blocks[NANOARROW_POOL_N_CLASSES];
+  int64_t cached_bytes;
+  int registered;
+};
+
+static __thread struct ArrowBufferAllocatorPoolCache ArrowBufferAllocatorPoolThreadCache;
+
+static struct ArrowBufferAllocatorPoolCache ArrowBufferAllocatorPoolGlobalCache;
+static pthread_mutex_t ArrowBufferAllocatorPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t ArrowBufferAllocatorPoolKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t ArrowBufferAllocatorPoolKey;
+
+// Returns the size class for size or -1 if size is too big to be pooled
+static int ArrowBufferAllocatorPoolSizeClass(int64_t size) {
+  if (size > ((int64_t)1 << NANOARROW_POOL_MAX_SHIFT)) {
+    return -1;
+  }
+
+  int shift = NANOARROW_POOL_MIN_SHIFT;
+  while (((int64_t)1 << shift) < size) {
+    shift++;
+  }
+
+  return shift - NANOARROW_POOL_MIN_SHIFT;
+}
+
+static int64_t ArrowBufferAllocatorPoolClassSize(int size_class) {
+  return (int64_t)1 << (size_class + NANOARROW_POOL_MIN_SHIFT);
+}
+
+static void ArrowBufferAllocatorPoolPush(struct ArrowBufferAllocatorPoolCache* cache,
+                                         int size_class,
+                                         struct ArrowBufferAllocatorPoolBlock* block) {
+  block->next = cache->blocks[size_class];
+  cache->blocks[size_class] = block;
+  cache->n_blocks[size_class]++;
+  cache->cached_bytes += ArrowBufferAllocatorPoolClassSize(size_class);
+}
+
+static struct ArrowBufferAllocatorPoolBlock* ArrowBufferAllocatorPoolPop(
+    struct ArrowBufferAllocatorPoolCache* cache, int size_class) {
+  struct ArrowBufferAllocatorPoolBlock* block = cache->blocks[size_class];
+  if (block != NULL) {
+    cache->blocks[size_class] = block->next;
+    cache->n_blocks[size_class]--;
+    cache->cached_bytes -= ArrowBufferAllocatorPoolClassSize(size_class);
+  }
+
+  return block;
+}
+
+// Move blocks from cache to the global pool, returning the blocks that do not
+// fit to the system. If keep_recent is non-zero, each size class keeps the more
+// recently freed half of its blocks (which are at the front of its free list
+// and most likely to still be in this core's cache); otherwise every block is
+// moved.
+static void ArrowBufferAllocatorPoolFlush(struct ArrowBufferAllocatorPoolCache* cache,
+                                          int keep_recent) {
+  struct ArrowBufferAllocatorPoolCache* global = &ArrowBufferAllocatorPoolGlobalCache;
+
+  // Detach the blocks to move before taking the lock
+  struct ArrowBufferAllocatorPoolBlock* moved[NANOARROW_POOL_N_CLASSES];
+  for (int i = 0; i < NANOARROW_POOL_N_CLASSES; i++) {
+    int64_t n_keep = keep_recent ? (cache->n_blocks[i] + 1) / 2 : 0;
+    struct ArrowBufferAllocatorPoolBlock** tail = &cache->blocks[i];
+    for (int64_t j = 0; j < n_keep; j++) {
+      tail = &(*tail)->next;
+    }
+
+    moved[i] = *tail;
+    *tail = NULL;
+    cache->cached_bytes -=
+        (cache->n_blocks[i] - n_keep) * ArrowBufferAllocatorPoolClassSize(i);
+    cache->n_blocks[i] = n_keep;
+  }
+
+  pthread_mutex_lock(&ArrowBufferAllocatorPoolMutex);
+  for (int i = 0; i < NANOARROW_POOL_N_CLASSES; i++) {
+    struct ArrowBufferAllocatorPoolBlock* block = moved[i];
+    while (block != NULL) {
+      struct ArrowBufferAllocatorPoolBlock* next = block->next;
+      if (global->cached_bytes < NANOARROW_POOL_GLOBAL_CACHE_BYTES) {
+        ArrowBufferAllocatorPoolPush(global, i, block);
+      } else {
+        free(block);
+      }
+
+      block = next;
+    }
+  }
+  pthread_mutex_unlock(&ArrowBufferAllocatorPoolMutex);
+}
+
+static void ArrowBufferAllocatorPoolThreadExit(void* ptr) {
+  ArrowBufferAllocatorPoolFlush((struct ArrowBufferAllocatorPoolCache*)ptr, 0);
+}
+
+static void ArrowBufferAllocatorPoolCreateKey(void) {
+  pthread_key_create(&ArrowBufferAllocatorPoolKey, &ArrowBufferAllocatorPoolThreadExit);
+}
+
+static struct ArrowBufferAllocatorPoolCache* ArrowBufferAllocatorPoolGetCache(void) {
+  struct ArrowBufferAllocatorPoolCache* cache = &ArrowBufferAllocatorPoolThreadCache;
+
+  // Registering the cache with a key ensures that its blocks are given back to
+  // the global pool when the thread exits
+  if (!cache->registered) {
+    pthread_once(&ArrowBufferAllocatorPoolKeyOnce, &ArrowBufferAllocatorPoolCreateKey);
+    pthread_setspecific(ArrowBufferAllocatorPoolKey, cache);
+    cache->registered = 1;
+  }
+
+  return cache;
+}
+
+static uint8_t* ArrowBufferAllocatorPoolAllocate(struct ArrowBufferAllocator* allocator,
+                                                 int64_t size) {
+  if (size <= 0) {
+    return NULL;
+  }
+
+  int size_class = ArrowBufferAllocatorPoolSizeClass(size);
+  if (size_class < 0) {
+    return (uint8_t*)malloc(size);
+  }
+
+  struct ArrowBufferAllocatorPoolCache* cache = ArrowBufferAllocatorPoolGetCache();
+  struct ArrowBufferAllocatorPoolBlock* block =
+      ArrowBufferAllocatorPoolPop(cache, size_class);
+  if (block != NULL) {
+    return (uint8_t*)block;
+  }
+
+  // Refill this thread's cache from the global pool
+  struct ArrowBufferAllocatorPoolCache* global = &ArrowBufferAllocatorPoolGlobalCache;
+  pthread_mutex_lock(&ArrowBufferAllocatorPoolMutex);
+  block = ArrowBufferAllocatorPoolPop(global, size_class);
+  for (int i = 1; block != NULL && i < NANOARROW_POOL_REFILL_BLOCKS; i++) {
+    struct ArrowBufferAllocatorPoolBlock* extra =
+        ArrowBufferAllocatorPoolPop(global, size_class);
+    if (extra == NULL) {
+      break;
+    }
+
+    ArrowBufferAllocatorPoolPush(cache, size_class, extra);
+  }
+  pthread_mutex_unlock(&ArrowBufferAllocatorPoolMutex);
+
+  if (block != NULL) {
+    return (uint8_t*)block;
+  }
+
+  return (uint8_t*)malloc(ArrowBufferAllocatorPoolClassSize(size_class));
+}
+
+static void ArrowBufferAllocatorPoolFree(struct ArrowBufferAllocator* allocator,
+                                         uint8_t* ptr, int64_t size) {
+  if (ptr == NULL) {
+    return;
+  }
+
+  int size_class = ArrowBufferAllocatorPoolSizeClass(size);
+  if (size_class < 0) {
+    free(ptr);
+    return;
+  }
+
+  struct ArrowBufferAllocatorPoolCache* cache = ArrowBufferAllocatorPoolGetCache();
+  ArrowBufferAllocatorPoolPush(cache, size_class,
+                               (struct ArrowBufferAllocatorPoolBlock*)ptr);
+  if (cache->cached_bytes > NANOARROW_POOL_THREAD_CACHE_BYTES) {
+    ArrowBufferAllocatorPoolFlush(cache, 1);
+  }
+}
+
+static uint8_t* ArrowBufferAllocatorPoolReallocate(struct ArrowBufferAllocator* allocator,
+                                                   uint8_t* ptr, int64_t old_size,
+                                                   int64_t new_size) {
+  if (ptr == NULL) {
+    return ArrowBufferAllocatorPoolAllocate(allocator, new_size);
+  }
+
+  if (new_size <= 0) {
+    ArrowBufferAllocatorPoolFree(allocator, ptr, old_size);
+    return NULL;
+  }
+
+  int old_class = ArrowBufferAllocatorPoolSizeClass(old_size);
+  int new_class = ArrowBufferAllocatorPoolSizeClass(new_size);
+  if (old_class >= 0 && old_class == new_class) {
+    return ptr;
+  } else if (old_class < 0 && new_class < 0) {
+    return (uint8_t*)realloc(ptr, new_size);
+  }
+
+  uint8_t* out = ArrowBufferAllocatorPoolAllocate(allocator, new_size);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  memcpy(out, ptr, old_size < new_size ? old_size : new_size);
+  ArrowBufferAllocatorPoolFree(allocator, ptr, old_size);
+  return out;
+}
+
+static struct ArrowBufferAllocator ArrowBufferAllocatorPoolInstance = {
+    &ArrowBufferAllocatorPoolAllocate, &ArrowBufferAllocatorPoolReallocate,
+    &ArrowBufferAllocatorPoolFree, NULL, NULL};
+
+struct ArrowBufferAllocator* ArrowBufferAllocatorPool() {
+  return &ArrowBufferAllocatorPoolInstance;
+}
+
+void ArrowBufferAllocatorPoolTrim() {
+  ArrowBufferAllocatorPoolFlush(ArrowBufferAllocatorPoolGetCache(), 0);
+
+  struct ArrowBufferAllocatorPoolCache* global = &ArrowBufferAllocatorPoolGlobalCache;
+  pthread_mutex_lock(&ArrowBufferAllocatorPoolMutex);
+  for (int i = 0; i < NANOARROW_POOL_N_CLASSES; i++) {
+    struct ArrowBufferAllocatorPoolBlock* block;
+    while ((block = ArrowBufferAllocatorPoolPop(global, i)) != NULL) {
+      free(block);
+    }
+  }
+  pthread_mutex_unlock(&ArrowBufferAllocatorPoolMutex);
+}
+
+#else
+
+struct ArrowBufferAllocator* ArrowBufferAllocatorPool() {
+  return ArrowBufferAllocatorDefault();
+}
+
+void ArrowBufferAllocatorPoolTrim() {}
+
+#endif
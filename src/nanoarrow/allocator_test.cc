@@ -15,8 +15,13 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstring>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <arrow/memory_pool.h>
 #include <gtest/gtest.h>
@@ -57,6 +62,7 @@ static void MemoryPoolAllocatorInit(MemoryPool* pool,
   allocator->allocate = &MemoryPoolAllocate;
   allocator->reallocate = &MemoryPoolReallocate;
   allocator->free = &MemoryPoolFree;
+  allocator->allocate_zeroed = nullptr;
   allocator->private_data = pool;
 }
 
@@ -80,6 +86,65 @@ TEST(AllocatorTest, AllocatorTestDefault) {
   EXPECT_EQ(buffer, nullptr);
 }
 
+TEST(AllocatorTest, AllocatorTestZeroed) {
+  std::vector<struct ArrowBufferAllocator*> allocators = {
+      ArrowBufferAllocatorDefault(), ArrowBufferAllocatorMmap()};
+  std::vector<int64_t> sizes = {1, 1000, 4 << 20};
+
+  for (struct ArrowBufferAllocator* allocator : allocators) {
+    ASSERT_NE(allocator->allocate_zeroed, nullptr);
+    for (int64_t size : sizes) {
+      uint8_t* buffer = allocator->allocate_zeroed(allocator, size);
+      ASSERT_NE(buffer, nullptr);
+      EXPECT_EQ(std::count(buffer, buffer + size, 0), size);
+      allocator->free(allocator, buffer, size);
+    }
+  }
+
+  // Recycled blocks are zeroed before they are handed out again
+  struct ArrowBufferAllocator recycling;
+  ASSERT_EQ(ArrowBufferAllocatorRecyclingInit(&recycling, ArrowBufferAllocatorDefault(),
+                                              1 << 20),
+            NANOARROW_OK);
+  uint8_t* buffer = recycling.allocate(&recycling, 100);
+  memset(buffer, 0xff, 100);
+  recycling.free(&recycling, buffer, 100);
+  buffer = recycling.allocate_zeroed(&recycling, 100);
+  EXPECT_EQ(std::count(buffer, buffer + 100, 0), 100);
+
+  struct ArrowBufferAllocatorRecyclingStats recycling_stats;
+  ArrowBufferAllocatorRecyclingGetStats(&recycling, &recycling_stats);
+  EXPECT_EQ(recycling_stats.n_hits, 1);
+  recycling.free(&recycling, buffer, 100);
+  ArrowBufferAllocatorRecyclingRelease(&recycling);
+
+  // Wrapping allocators zero the memory themselves if their base allocator can't
+  struct ArrowBufferAllocator counted;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&counted, ArrowBufferAllocatorAligned()),
+            NANOARROW_OK);
+  buffer = counted.allocate_zeroed(&counted, 100);
+  EXPECT_EQ(std::count(buffer, buffer + 100, 0), 100);
+
+  struct ArrowBufferAllocatorStats stats;
+  ArrowBufferAllocatorStatsGet(&counted, &stats);
+  EXPECT_EQ(stats.n_allocations, 1);
+  EXPECT_EQ(stats.bytes_allocated, 100);
+  counted.free(&counted, buffer, 100);
+  ArrowBufferAllocatorStatsRelease(&counted);
+
+  struct ArrowBufferAllocator limit;
+  ASSERT_EQ(ArrowBufferAllocatorLimitInit(&limit, ArrowBufferAllocatorDefault(), 100, 100,
+                                          nullptr, nullptr),
+            NANOARROW_OK);
+  EXPECT_EQ(limit.allocate_zeroed(&limit, 101), nullptr);
+  buffer = limit.allocate_zeroed(&limit, 100);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&limit), 100);
+  limit.free(&limit, buffer, 100);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&limit), 0);
+  ArrowBufferAllocatorLimitRelease(&limit);
+}
+
 TEST(AllocatorTest, AllocatorTestMemoryPool) {
   struct ArrowBufferAllocator arrow_allocator;
   MemoryPoolAllocatorInit(system_memory_pool(), &arrow_allocator);
@@ -108,3 +173,601 @@ TEST(AllocatorTest, AllocatorTestMemoryPool) {
                                       std::numeric_limits<int64_t>::max());
   EXPECT_EQ(buffer, nullptr);
 }
+
+TEST(AllocatorTest, AllocatorTestArena) {
+  struct ArrowBufferAllocator allocator;
+  EXPECT_EQ(ArrowBufferAllocatorArenaInit(&allocator, 0), EINVAL);
+  ASSERT_EQ(ArrowBufferAllocatorArenaInit(&allocator, 1024), NANOARROW_OK);
+
+  // Allocations are handed out from the same chunk
+  uint8_t* buffer0 = allocator.allocate(&allocator, 10);
+  uint8_t* buffer1 = allocator.allocate(&allocator, 10);
+  ASSERT_NE(buffer0, nullptr);
+  ASSERT_NE(buffer1, nullptr);
+  EXPECT_EQ(buffer1 - buffer0, 16);
+
+  // Reallocating the most recent allocation happens in place
+  const char* test_str = "abcdefg";
+  memcpy(buffer1, test_str, strlen(test_str) + 1);
+  EXPECT_EQ(allocator.reallocate(&allocator, buffer1, 10, 100), buffer1);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer1), test_str);
+
+  // ...but reallocating anything else copies
+  memcpy(buffer0, test_str, strlen(test_str) + 1);
+  uint8_t* buffer2 = allocator.reallocate(&allocator, buffer0, 10, 100);
+  EXPECT_NE(buffer2, buffer0);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer2), test_str);
+
+  // Freeing the most recent allocation lets the space be reused
+  allocator.free(&allocator, buffer2, 100);
+  EXPECT_EQ(allocator.allocate(&allocator, 10), buffer2);
+
+  // Allocations bigger than a chunk get their own chunk and do not waste
+  // the remaining space in the current chunk
+  uint8_t* big = allocator.allocate(&allocator, 4096);
+  ASSERT_NE(big, nullptr);
+  memset(big, 0, 4096);
+  EXPECT_EQ(allocator.allocate(&allocator, 10) - buffer2, 16);
+
+  EXPECT_EQ(allocator.allocate(&allocator, 0), nullptr);
+  EXPECT_EQ(allocator.allocate(&allocator, std::numeric_limits<int64_t>::max()), nullptr);
+
+  // Reset rewinds the arena
+  ArrowBufferAllocatorArenaReset(&allocator);
+  EXPECT_EQ(allocator.allocate(&allocator, 10), buffer0);
+
+  ArrowBufferAllocatorArenaRelease(&allocator);
+  EXPECT_EQ(allocator.private_data, nullptr);
+}
+
+TEST(AllocatorTest, AllocatorTestArenaBuffers) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorArenaInit(&allocator, 1024), NANOARROW_OK);
+
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &allocator), NANOARROW_OK);
+
+  // Growing the only buffer in the arena never moves it
+  ASSERT_EQ(ArrowBufferAppend(&buffer, "abcd", 4), NANOARROW_OK);
+  uint8_t* first_data = buffer.data;
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(ArrowBufferAppend(&buffer, "abcd", 4), NANOARROW_OK);
+  }
+
+  EXPECT_EQ(buffer.data, first_data);
+  EXPECT_EQ(buffer.size_bytes, 404);
+  EXPECT_EQ(memcmp(buffer.data + 400, "abcd", 4), 0);
+
+  // Growing past the end of the chunk moves it
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 2048), NANOARROW_OK);
+  EXPECT_NE(buffer.data, first_data);
+  EXPECT_EQ(memcmp(buffer.data + 400, "abcd", 4), 0);
+
+  ArrowBufferReset(&buffer);
+  ArrowBufferAllocatorArenaRelease(&allocator);
+}
+
+TEST(AllocatorTest, AllocatorTestPool) {
+  struct ArrowBufferAllocator* allocator = ArrowBufferAllocatorPool();
+
+  uint8_t* buffer = allocator->allocate(allocator, 10);
+  ASSERT_NE(buffer, nullptr);
+  const char* test_str = "abcdefg";
+  memcpy(buffer, test_str, strlen(test_str) + 1);
+
+  // Reallocating within a size class happens in place
+  EXPECT_EQ(allocator->reallocate(allocator, buffer, 10, 64), buffer);
+
+  // Reallocating to a different size class copies
+  buffer = allocator->reallocate(allocator, buffer, 64, 1000);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer), test_str);
+
+  // Freed blocks are recycled
+  allocator->free(allocator, buffer, 1000);
+  EXPECT_EQ(allocator->allocate(allocator, 1024), buffer);
+  allocator->free(allocator, buffer, 1024);
+
+  // Allocations too big to pool still work
+  buffer = allocator->allocate(allocator, 10 << 20);
+  ASSERT_NE(buffer, nullptr);
+  memcpy(buffer, test_str, strlen(test_str) + 1);
+  buffer = allocator->reallocate(allocator, buffer, 10 << 20, 100);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer), test_str);
+  allocator->free(allocator, buffer, 100);
+
+  EXPECT_EQ(allocator->allocate(allocator, 0), nullptr);
+  EXPECT_EQ(allocator->allocate(allocator, std::numeric_limits<int64_t>::max()),
+            nullptr);
+
+  // Going over the (default 4 MiB) thread cache limit only gives away the least
+  // recently freed blocks, so the block freed last is still the next one handed out
+  ArrowBufferAllocatorPoolTrim();
+  std::vector<uint8_t*> blocks;
+  for (int i = 0; i < 5; i++) {
+    blocks.push_back(allocator->allocate(allocator, 1 << 20));
+    ASSERT_NE(blocks.back(), nullptr);
+  }
+  for (uint8_t* block : blocks) {
+    allocator->free(allocator, block, 1 << 20);
+  }
+  EXPECT_EQ(allocator->allocate(allocator, 1 << 20), blocks.back());
+  allocator->free(allocator, blocks.back(), 1 << 20);
+
+  ArrowBufferAllocatorPoolTrim();
+}
+
+TEST(AllocatorTest, AllocatorTestPoolThreads) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([i] {
+      struct ArrowBuffer buffer;
+      for (int j = 0; j < 200; j++) {
+        ArrowBufferInit(&buffer);
+        ASSERT_EQ(ArrowBufferSetAllocator(&buffer, ArrowBufferAllocatorPool()),
+                  NANOARROW_OK);
+        for (int k = 0; k < 1000 * (j % 5); k++) {
+          ASSERT_EQ(ArrowBufferAppend(&buffer, &i, sizeof(int)), NANOARROW_OK);
+        }
+
+        for (int64_t k = 0; k < buffer.size_bytes / (int64_t)sizeof(int); k++) {
+          ASSERT_EQ(reinterpret_cast<int*>(buffer.data)[k], i);
+        }
+
+        ArrowBufferReset(&buffer);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ArrowBufferAllocatorPoolTrim();
+}
+
+TEST(AllocatorTest, AllocatorTestAligned) {
+  struct ArrowBufferAllocator* allocator = ArrowBufferAllocatorAligned();
+
+  uint8_t* buffer = allocator->allocate(allocator, 10);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer) % 64, 0);
+  const char* test_str = "abcdefg";
+  memcpy(buffer, test_str, strlen(test_str) + 1);
+
+  // Growing within the padding happens in place
+  EXPECT_EQ(allocator->reallocate(allocator, buffer, 10, 64), buffer);
+
+  // Growing beyond the padding keeps the alignment
+  buffer = allocator->reallocate(allocator, buffer, 64, 1000);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer) % 64, 0);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer), test_str);
+
+  // The padding is usable memory
+  memset(buffer, 0, 1024);
+
+  allocator->free(allocator, buffer, 1000);
+
+  EXPECT_EQ(allocator->allocate(allocator, 0), nullptr);
+  EXPECT_EQ(allocator->allocate(allocator, std::numeric_limits<int64_t>::max()),
+            nullptr);
+}
+
+TEST(AllocatorTest, AllocatorTestAlignedBuffers) {
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, ArrowBufferAllocatorAligned()),
+            NANOARROW_OK);
+
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(ArrowBufferAppend(&buffer, &i, sizeof(int)), NANOARROW_OK);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(buffer.data) % 64, 0);
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(reinterpret_cast<int*>(buffer.data)[i], i);
+  }
+
+  ArrowBufferReset(&buffer);
+}
+
+TEST(AllocatorTest, AllocatorTestMmap) {
+  struct ArrowBufferAllocator* allocator = ArrowBufferAllocatorMmap();
+  const char* test_str = "abcdefg";
+
+  // Small allocations
+  uint8_t* buffer = allocator->allocate(allocator, 10);
+  ASSERT_NE(buffer, nullptr);
+  memcpy(buffer, test_str, strlen(test_str) + 1);
+  buffer = allocator->reallocate(allocator, buffer, 10, 100);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer), test_str);
+
+  // Crossing the threshold
+  int64_t big_size = 8 << 20;
+  buffer = allocator->reallocate(allocator, buffer, 100, big_size);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer), test_str);
+  buffer[big_size - 1] = 'x';
+
+  // Growing a mapped allocation
+  buffer = allocator->reallocate(allocator, buffer, big_size, big_size * 4);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer), test_str);
+  EXPECT_EQ(buffer[big_size - 1], 'x');
+  buffer[big_size * 4 - 1] = 'y';
+
+  // Shrinking below the threshold
+  buffer = allocator->reallocate(allocator, buffer, big_size * 4, 10);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(memcmp(buffer, test_str, 8), 0);
+  allocator->free(allocator, buffer, 10);
+
+  buffer = allocator->allocate(allocator, big_size);
+  ASSERT_NE(buffer, nullptr);
+  memset(buffer, 0, big_size);
+  allocator->free(allocator, buffer, big_size);
+
+  EXPECT_EQ(allocator->allocate(allocator, std::numeric_limits<int64_t>::max()),
+            nullptr);
+}
+
+TEST(AllocatorTest, AllocatorTestMmapBuffers) {
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, ArrowBufferAllocatorMmap()), NANOARROW_OK);
+
+  int64_t n_values = 4 << 20;
+  for (int64_t i = 0; i < n_values; i++) {
+    ASSERT_EQ(ArrowBufferAppend(&buffer, &i, sizeof(int64_t)), NANOARROW_OK);
+  }
+
+  for (int64_t i = 0; i < n_values; i++) {
+    ASSERT_EQ(reinterpret_cast<int64_t*>(buffer.data)[i], i);
+  }
+
+  ArrowBufferReset(&buffer);
+}
+
+TEST(AllocatorTest, AllocatorTestStats) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&allocator, ArrowBufferAllocatorAligned()),
+            NANOARROW_OK);
+
+  struct ArrowBufferAllocatorStats stats;
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+  EXPECT_EQ(stats.peak_bytes_allocated, 0);
+  EXPECT_EQ(stats.n_allocations, 0);
+  EXPECT_EQ(stats.n_reallocations, 0);
+  EXPECT_EQ(stats.n_frees, 0);
+  EXPECT_EQ(stats.bytes_copied, 0);
+
+  uint8_t* buffer0 = allocator.allocate(&allocator, 10);
+  uint8_t* buffer1 = allocator.reallocate(&allocator, nullptr, 0, 20);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 30);
+  EXPECT_EQ(stats.n_allocations, 2);
+
+  // Growing within the aligned allocator's padding does not copy
+  buffer0 = allocator.reallocate(&allocator, buffer0, 10, 64);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 84);
+  EXPECT_EQ(stats.n_reallocations, 1);
+  EXPECT_EQ(stats.bytes_copied, 0);
+
+  // ...but growing beyond it does
+  buffer0 = allocator.reallocate(&allocator, buffer0, 64, 1000);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 1020);
+  EXPECT_EQ(stats.n_reallocations, 2);
+  EXPECT_EQ(stats.bytes_copied, 64);
+
+  allocator.free(&allocator, buffer0, 1000);
+  EXPECT_EQ(allocator.reallocate(&allocator, buffer1, 20, 0), nullptr);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+  EXPECT_EQ(stats.peak_bytes_allocated, 1020);
+  EXPECT_EQ(stats.n_frees, 2);
+
+  // Failed allocations are not recorded
+  EXPECT_EQ(allocator.allocate(&allocator, std::numeric_limits<int64_t>::max()),
+            nullptr);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.n_allocations, 2);
+
+  ArrowBufferAllocatorStatsRelease(&allocator);
+  EXPECT_EQ(allocator.private_data, nullptr);
+}
+
+TEST(AllocatorTest, AllocatorTestStatsThreads) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&allocator, ArrowBufferAllocatorDefault()),
+            NANOARROW_OK);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&allocator] {
+      for (int j = 0; j < 1000; j++) {
+        struct ArrowBuffer buffer;
+        ArrowBufferInit(&buffer);
+        ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &allocator), NANOARROW_OK);
+        ASSERT_EQ(ArrowBufferAppend(&buffer, "abcd", 4), NANOARROW_OK);
+        ASSERT_EQ(ArrowBufferAppend(&buffer, "efgh", 4), NANOARROW_OK);
+        ArrowBufferReset(&buffer);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  struct ArrowBufferAllocatorStats stats;
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+  EXPECT_EQ(stats.n_allocations, 8000);
+  EXPECT_EQ(stats.n_reallocations, 8000);
+  EXPECT_EQ(stats.n_frees, 8000);
+  EXPECT_GE(stats.peak_bytes_allocated, 8);
+  EXPECT_LE(stats.peak_bytes_allocated, 64);
+
+  ArrowBufferAllocatorStatsRelease(&allocator);
+}
+
+static void LimitCallback(struct ArrowBufferAllocator* allocator,
+                          int64_t bytes_allocated, void* callback_data) {
+  reinterpret_cast<std::vector<int64_t>*>(callback_data)->push_back(bytes_allocated);
+}
+
+TEST(AllocatorTest, AllocatorTestLimit) {
+  struct ArrowBufferAllocator allocator;
+  std::vector<int64_t> crossings;
+  EXPECT_EQ(ArrowBufferAllocatorLimitInit(&allocator, ArrowBufferAllocatorDefault(), -1,
+                                          100, nullptr, nullptr),
+            EINVAL);
+  ASSERT_EQ(ArrowBufferAllocatorLimitInit(&allocator, ArrowBufferAllocatorDefault(), 50,
+                                          100, &LimitCallback, &crossings),
+            NANOARROW_OK);
+
+  uint8_t* buffer0 = allocator.allocate(&allocator, 40);
+  ASSERT_NE(buffer0, nullptr);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 40);
+  EXPECT_TRUE(crossings.empty());
+
+  // Crossing the soft limit calls the callback once
+  uint8_t* buffer1 = allocator.reallocate(&allocator, nullptr, 0, 20);
+  ASSERT_NE(buffer1, nullptr);
+  buffer1 = allocator.reallocate(&allocator, buffer1, 20, 30);
+  ASSERT_NE(buffer1, nullptr);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 70);
+  EXPECT_EQ(crossings, std::vector<int64_t>({60}));
+
+  // Exceeding the hard limit fails without changing the total
+  EXPECT_EQ(allocator.allocate(&allocator, 31), nullptr);
+  EXPECT_EQ(allocator.reallocate(&allocator, buffer1, 30, 61), nullptr);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 70);
+
+  // Shrinking gives bytes back
+  buffer1 = allocator.reallocate(&allocator, buffer1, 30, 5);
+  ASSERT_NE(buffer1, nullptr);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 45);
+
+  // Crossing the soft limit again calls the callback again
+  buffer1 = allocator.reallocate(&allocator, buffer1, 5, 60);
+  ASSERT_NE(buffer1, nullptr);
+  EXPECT_EQ(crossings, std::vector<int64_t>({60, 100}));
+
+  allocator.free(&allocator, buffer0, 40);
+  allocator.free(&allocator, buffer1, 60);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 0);
+
+  ArrowBufferAllocatorLimitRelease(&allocator);
+  EXPECT_EQ(allocator.private_data, nullptr);
+}
+
+TEST(AllocatorTest, AllocatorTestLimitBuffers) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorLimitInit(&allocator, ArrowBufferAllocatorDefault(),
+                                          1024, 1024, nullptr, nullptr),
+            NANOARROW_OK);
+
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &allocator), NANOARROW_OK);
+  EXPECT_EQ(ArrowBufferReserve(&buffer, 1000), NANOARROW_OK);
+  EXPECT_EQ(ArrowBufferReserve(&buffer, 2000), ENOMEM);
+  ArrowBufferReset(&buffer);
+
+  ArrowBufferAllocatorLimitRelease(&allocator);
+
+  // Many threads sharing a budget never exceed it. The limit allocator wraps a
+  // statistics allocator so that the peak is measured independently of the
+  // limit allocator's own accounting.
+  struct ArrowBufferAllocator stats;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&stats, ArrowBufferAllocatorDefault()),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAllocatorLimitInit(&allocator, &stats, 1024, 1024, nullptr,
+                                          nullptr),
+            NANOARROW_OK);
+
+  std::atomic<int64_t> n_rejected(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.emplace_back([&allocator, &n_rejected] {
+      for (int j = 0; j < 1000; j++) {
+        struct ArrowBuffer buffer;
+        ArrowBufferInit(&buffer);
+        ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &allocator), NANOARROW_OK);
+        if (ArrowBufferReserve(&buffer, 200) == NANOARROW_OK) {
+          ASSERT_LE(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 1024);
+          std::this_thread::yield();
+        } else {
+          n_rejected++;
+        }
+        ArrowBufferReset(&buffer);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  struct ArrowBufferAllocatorStats stats_out;
+  ArrowBufferAllocatorStatsGet(&stats, &stats_out);
+  EXPECT_LE(stats_out.peak_bytes_allocated, 1024);
+  EXPECT_EQ(stats_out.bytes_allocated, 0);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 0);
+  EXPECT_EQ(n_rejected + stats_out.n_allocations, 8 * 1000);
+  ArrowBufferAllocatorLimitRelease(&allocator);
+  ArrowBufferAllocatorStatsRelease(&stats);
+}
+
+TEST(AllocatorTest, AllocatorTestMallocSetAllocator) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&allocator, ArrowBufferAllocatorPool()),
+            NANOARROW_OK);
+  ArrowMallocSetAllocator(&allocator);
+
+  void* ptr = ArrowMalloc(10);
+  ASSERT_NE(ptr, nullptr);
+  const char* test_str = "abcdefg";
+  memcpy(ptr, test_str, strlen(test_str) + 1);
+  ptr = ArrowRealloc(ptr, 1000);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_STREQ(reinterpret_cast<const char*>(ptr), test_str);
+  EXPECT_EQ(ArrowMalloc(std::numeric_limits<int64_t>::max()), nullptr);
+  EXPECT_EQ(ArrowRealloc(ptr, std::numeric_limits<int64_t>::max()), nullptr);
+
+  struct ArrowBufferAllocatorStats stats;
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 1016);
+
+  ArrowFree(ptr);
+  ArrowFree(nullptr);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+
+  // Schemas allocate through the allocator
+  struct ArrowSchema schema;
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaSetName(&schema, "name"), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(&schema, 2), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[0], NANOARROW_TYPE_INT32), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[1], NANOARROW_TYPE_STRING), NANOARROW_OK);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_GT(stats.n_allocations, 0);
+  EXPECT_GT(stats.bytes_allocated, 0);
+
+  schema.release(&schema);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+  EXPECT_EQ(stats.n_frees, stats.n_allocations);
+
+  ArrowMallocSetAllocator(nullptr);
+  ArrowBufferAllocatorStatsRelease(&allocator);
+  ArrowBufferAllocatorPoolTrim();
+}
+
+TEST(AllocatorTest, AllocatorTestRecycling) {
+  struct ArrowBufferAllocator allocator;
+  EXPECT_EQ(ArrowBufferAllocatorRecyclingInit(&allocator, ArrowBufferAllocatorDefault(),
+                                              -1),
+            EINVAL);
+  ASSERT_EQ(ArrowBufferAllocatorRecyclingInit(&allocator, ArrowBufferAllocatorDefault(),
+                                              1024),
+            NANOARROW_OK);
+
+  struct ArrowBufferAllocatorRecyclingStats stats;
+  uint8_t* buffer0 = allocator.allocate(&allocator, 100);
+  ASSERT_NE(buffer0, nullptr);
+  ArrowBufferAllocatorRecyclingGetStats(&allocator, &stats);
+  EXPECT_EQ(stats.n_hits, 0);
+  EXPECT_EQ(stats.n_misses, 1);
+
+  // Freed blocks are reused by smaller requests...
+  allocator.free(&allocator, buffer0, 100);
+  ArrowBufferAllocatorRecyclingGetStats(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_cached, 100);
+  EXPECT_EQ(allocator.allocate(&allocator, 10), buffer0);
+
+  // ...which can then grow in place up to the block's real capacity without
+  // counting as another hit
+  ArrowBufferAllocatorRecyclingGetStats(&allocator, &stats);
+  EXPECT_EQ(stats.n_hits, 1);
+  EXPECT_EQ(allocator.reallocate(&allocator, buffer0, 10, 100), buffer0);
+  ArrowBufferAllocatorRecyclingGetStats(&allocator, &stats);
+  EXPECT_EQ(stats.n_hits, 1);
+  EXPECT_EQ(stats.n_misses, 1);
+  EXPECT_EQ(stats.bytes_cached, 0);
+
+  const char* test_str = "abcdefg";
+  memcpy(buffer0, test_str, strlen(test_str) + 1);
+  buffer0 = allocator.reallocate(&allocator, buffer0, 100, 200);
+  ASSERT_NE(buffer0, nullptr);
+  EXPECT_STREQ(reinterpret_cast<const char*>(buffer0), test_str);
+  ArrowBufferAllocatorRecyclingGetStats(&allocator, &stats);
+  EXPECT_EQ(stats.n_misses, 2);
+
+  // Blocks that do not fit in the cache go back to the base allocator
+  uint8_t* buffer1 = allocator.allocate(&allocator, 2000);
+  ASSERT_NE(buffer1, nullptr);
+  allocator.free(&allocator, buffer1, 2000);
+  allocator.free(&allocator, buffer0, 200);
+  ArrowBufferAllocatorRecyclingGetStats(&allocator, &stats);
+  EXPECT_EQ(stats.bytes_cached, 200);
+
+  EXPECT_EQ(allocator.allocate(&allocator, 0), nullptr);
+  EXPECT_EQ(allocator.allocate(&allocator, std::numeric_limits<int64_t>::max()),
+            nullptr);
+
+  ArrowBufferAllocatorRecyclingRelease(&allocator);
+  EXPECT_EQ(allocator.private_data, nullptr);
+}
+
+TEST(AllocatorTest, AllocatorTestRecyclingBatches) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorRecyclingInit(&allocator, ArrowBufferAllocatorDefault(),
+                                              1 << 20),
+            NANOARROW_OK);
+
+  struct ArrowBufferAllocatorRecyclingStats stats;
+  int64_t misses_after_warmup = 0;
+
+  for (int batch = 0; batch < 5; batch++) {
+    struct ArrowBuffer validity;
+    struct ArrowBuffer data;
+    ArrowBufferInit(&validity);
+    ArrowBufferInit(&data);
+    ASSERT_EQ(ArrowBufferSetAllocator(&validity, &allocator), NANOARROW_OK);
+    ASSERT_EQ(ArrowBufferSetAllocator(&data, &allocator), NANOARROW_OK);
+
+    for (int64_t i = 0; i < 1000; i++) {
+      ASSERT_EQ(ArrowBufferAppend(&data, &i, sizeof(int64_t)), NANOARROW_OK);
+      if (i % 8 == 0) {
+        uint8_t all_valid = 0xff;
+        ASSERT_EQ(ArrowBufferAppend(&validity, &all_valid, 1), NANOARROW_OK);
+      }
+    }
+
+    ArrowBufferReset(&validity);
+    ArrowBufferReset(&data);
+
+    ArrowBufferAllocatorRecyclingGetStats(&allocator, &stats);
+    if (batch == 1) {
+      misses_after_warmup = stats.n_misses;
+    }
+  }
+
+  // Once the cache holds blocks big enough for every buffer in the batch
+  // (which here takes two batches because the first request of each batch
+  // can be served by either block), batches never call the base allocator
+  EXPECT_EQ(stats.n_misses, misses_after_warmup);
+  EXPECT_GT(stats.n_hits, 0);
+
+  ArrowBufferAllocatorRecyclingRelease(&allocator);
+}
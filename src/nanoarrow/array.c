@@ -0,0 +1,287 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+// The private data of an array built by nanoarrow. The buffers are owned here
+// and array->buffers points at buffer_data so that finishing the array does
+// not have to allocate or copy anything.
+struct ArrowArrayPrivateData {
+  struct ArrowBuffer buffers[3];
+  const void* buffer_data[3];
+  enum ArrowType storage_type;
+};
+
+// Consumers may read the first offset of an empty array, so empty offset and
+// data buffers are exported as a pointer to zeroes rather than NULL
+static const int64_t kArrowArrayEmptyBuffer[1] = {0};
+
+static void ArrowArrayRelease(struct ArrowArray* array) {
+  struct ArrowArrayPrivateData* private_data =
+      (struct ArrowArrayPrivateData*)array->private_data;
+
+  // This object owns the memory for all the children, but those
+  // children may have been generated elsewhere and might have
+  // their own release() callback. The child structs are allocated
+  // in the same block as the children array.
+  if (array->children != NULL) {
+    for (int64_t i = 0; i < array->n_children; i++) {
+      if (array->children[i] != NULL && array->children[i]->release != NULL) {
+        array->children[i]->release(array->children[i]);
+      }
+    }
+
+    ArrowFree(array->children);
+  }
+
+  // This object owns the memory for the dictionary but it
+  // may have been generated somewhere else and have its own
+  // release() callback.
+  if (array->dictionary != NULL) {
+    if (array->dictionary->release != NULL) {
+      array->dictionary->release(array->dictionary);
+    }
+
+    ArrowFree(array->dictionary);
+  }
+
+  if (private_data != NULL) {
+    for (int i = 0; i < 3; i++) {
+      ArrowBufferReset(&private_data->buffers[i]);
+    }
+
+    ArrowFree(private_data);
+  }
+
+  array->release = NULL;
+}
+
+// The number of buffers of each storage type in the C data interface
+static int ArrowArrayNumBuffers(enum ArrowType storage_type) {
+  switch (storage_type) {
+    case NANOARROW_TYPE_UNINITIALIZED:
+    case NANOARROW_TYPE_NA:
+      return 0;
+
+    case NANOARROW_TYPE_FIXED_SIZE_LIST:
+    case NANOARROW_TYPE_STRUCT:
+    case NANOARROW_TYPE_SPARSE_UNION:
+      return 1;
+
+    case NANOARROW_TYPE_BOOL:
+    case NANOARROW_TYPE_UINT8:
+    case NANOARROW_TYPE_INT8:
+    case NANOARROW_TYPE_UINT16:
+    case NANOARROW_TYPE_INT16:
+    case NANOARROW_TYPE_UINT32:
+    case NANOARROW_TYPE_INT32:
+    case NANOARROW_TYPE_UINT64:
+    case NANOARROW_TYPE_INT64:
+    case NANOARROW_TYPE_HALF_FLOAT:
+    case NANOARROW_TYPE_FLOAT:
+    case NANOARROW_TYPE_DOUBLE:
+    case NANOARROW_TYPE_DECIMAL128:
+    case NANOARROW_TYPE_DECIMAL256:
+    case NANOARROW_TYPE_INTERVAL_MONTHS:
+    case NANOARROW_TYPE_INTERVAL_DAY_TIME:
+    case NANOARROW_TYPE_INTERVAL_MONTH_DAY_NANO:
+    case NANOARROW_TYPE_FIXED_SIZE_BINARY:
+    case NANOARROW_TYPE_DATE32:
+    case NANOARROW_TYPE_DATE64:
+    case NANOARROW_TYPE_TIMESTAMP:
+    case NANOARROW_TYPE_TIME32:
+    case NANOARROW_TYPE_TIME64:
+    case NANOARROW_TYPE_DURATION:
+    case NANOARROW_TYPE_LIST:
+    case NANOARROW_TYPE_LARGE_LIST:
+    case NANOARROW_TYPE_MAP:
+    case NANOARROW_TYPE_DENSE_UNION:
+      return 2;
+
+    case NANOARROW_TYPE_STRING:
+    case NANOARROW_TYPE_LARGE_STRING:
+    case NANOARROW_TYPE_BINARY:
+    case NANOARROW_TYPE_LARGE_BINARY:
+      return 3;
+
+    default:
+      return -1;
+  }
+}
+
+ArrowErrorCode ArrowArrayInit(struct ArrowArray* array, enum ArrowType storage_type) {
+  array->length = 0;
+  array->null_count = 0;
+  array->offset = 0;
+  array->n_buffers = 0;
+  array->n_children = 0;
+  array->buffers = NULL;
+  array->children = NULL;
+  array->dictionary = NULL;
+  array->release = &ArrowArrayRelease;
+  array->private_data = NULL;
+
+  int n_buffers = ArrowArrayNumBuffers(storage_type);
+  if (n_buffers < 0) {
+    array->release(array);
+    return EINVAL;
+  }
+
+  struct ArrowArrayPrivateData* private_data =
+      (struct ArrowArrayPrivateData*)ArrowMalloc(sizeof(struct ArrowArrayPrivateData));
+  if (private_data == NULL) {
+    array->release(array);
+    return ENOMEM;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    ArrowBufferInit(&private_data->buffers[i]);
+    private_data->buffer_data[i] = NULL;
+  }
+
+  private_data->storage_type = storage_type;
+
+  array->n_buffers = n_buffers;
+  array->buffers = private_data->buffer_data;
+  array->private_data = private_data;
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowArrayAllocateChildren(struct ArrowArray* array, int64_t n_children) {
+  if (array->children != NULL) {
+    return EEXIST;
+  }
+
+  if (n_children > 0) {
+    // Allocate the array of pointers and the child structs in one block
+    array->children = (struct ArrowArray**)ArrowMalloc(
+        n_children * (sizeof(struct ArrowArray*) + sizeof(struct ArrowArray)));
+
+    if (array->children == NULL) {
+      return ENOMEM;
+    }
+
+    array->n_children = n_children;
+
+    struct ArrowArray* child_structs = (struct ArrowArray*)(array->children + n_children);
+    for (int64_t i = 0; i < n_children; i++) {
+      array->children[i] = child_structs + i;
+      array->children[i]->release = NULL;
+    }
+  }
+
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowArrayAllocateDictionary(struct ArrowArray* array) {
+  if (array->dictionary != NULL) {
+    return EEXIST;
+  }
+
+  array->dictionary = (struct ArrowArray*)ArrowMalloc(sizeof(struct ArrowArray));
+  if (array->dictionary == NULL) {
+    return ENOMEM;
+  }
+
+  array->dictionary->release = NULL;
+  return NANOARROW_OK;
+}
+
+struct ArrowBuffer* ArrowArrayBuffer(struct ArrowArray* array, int64_t i) {
+  if (array->release != &ArrowArrayRelease || i < 0 || i >= array->n_buffers) {
+    return NULL;
+  }
+
+  struct ArrowArrayPrivateData* private_data =
+      (struct ArrowArrayPrivateData*)array->private_data;
+  return &private_data->buffers[i];
+}
+
+ArrowErrorCode ArrowArraySetBuffer(struct ArrowArray* array, int64_t i,
+                                   struct ArrowBuffer* buffer) {
+  struct ArrowBuffer* array_buffer = ArrowArrayBuffer(array, i);
+  if (array_buffer == NULL) {
+    return EINVAL;
+  }
+
+  ArrowBufferReset(array_buffer);
+  ArrowBufferMove(buffer, array_buffer);
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowArrayFinishBuilding(struct ArrowArray* array,
+                                        struct ArrowError* error) {
+  if (array->release != &ArrowArrayRelease) {
+    ArrowErrorSet(error, "Expected array initialized with ArrowArrayInit()");
+    return EINVAL;
+  }
+
+  struct ArrowArrayPrivateData* private_data =
+      (struct ArrowArrayPrivateData*)array->private_data;
+
+  // A missing validity buffer means that all values are valid, but every other
+  // buffer (including the type ids that come first for unions) has to point
+  // somewhere
+  int64_t first_non_validity_buffer = 1;
+  if (private_data->storage_type == NANOARROW_TYPE_SPARSE_UNION ||
+      private_data->storage_type == NANOARROW_TYPE_DENSE_UNION) {
+    first_non_validity_buffer = 0;
+  }
+
+  for (int64_t i = 0; i < array->n_buffers; i++) {
+    const void* data = private_data->buffers[i].data;
+    if (data == NULL && i >= first_non_validity_buffer) {
+      data = kArrowArrayEmptyBuffer;
+    }
+
+    private_data->buffer_data[i] = data;
+  }
+
+  int result;
+  for (int64_t i = 0; i < array->n_children; i++) {
+    struct ArrowArray* child = array->children[i];
+    if (child == NULL || child->release == NULL) {
+      ArrowErrorSet(error, "Expected valid array at array->children[%d]", (int)i);
+      return EINVAL;
+    }
+
+    // Children built elsewhere are assumed to be complete
+    if (child->release == &ArrowArrayRelease) {
+      result = ArrowArrayFinishBuilding(child, error);
+      if (result != NANOARROW_OK) {
+        return result;
+      }
+    }
+  }
+
+  if (array->dictionary != NULL) {
+    if (array->dictionary->release == NULL) {
+      ArrowErrorSet(error, "Expected valid array at array->dictionary");
+      return EINVAL;
+    }
+
+    if (array->dictionary->release == &ArrowArrayRelease) {
+      return ArrowArrayFinishBuilding(array->dictionary, error);
+    }
+  }
+
+  return NANOARROW_OK;
+}
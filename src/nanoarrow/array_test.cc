@@ -0,0 +1,236 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+TEST(ArrayTest, ArrayInit) {
+  struct ArrowArray array;
+
+  EXPECT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_NA), NANOARROW_OK);
+  EXPECT_EQ(array.n_buffers, 0);
+  EXPECT_EQ(array.length, 0);
+  EXPECT_EQ(array.n_children, 0);
+  EXPECT_EQ(array.children, nullptr);
+  EXPECT_EQ(array.dictionary, nullptr);
+  EXPECT_EQ(ArrowArrayBuffer(&array, 0), nullptr);
+  array.release(&array);
+  EXPECT_EQ(array.release, nullptr);
+
+  EXPECT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  EXPECT_EQ(array.n_buffers, 1);
+  array.release(&array);
+
+  EXPECT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_INT32), NANOARROW_OK);
+  EXPECT_EQ(array.n_buffers, 2);
+  EXPECT_NE(ArrowArrayBuffer(&array, 1), nullptr);
+  EXPECT_EQ(ArrowArrayBuffer(&array, 2), nullptr);
+  EXPECT_EQ(ArrowArrayBuffer(&array, -1), nullptr);
+  array.release(&array);
+
+  EXPECT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_MAP), NANOARROW_OK);
+  EXPECT_EQ(array.n_buffers, 2);
+  array.release(&array);
+
+  EXPECT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_LARGE_STRING), NANOARROW_OK);
+  EXPECT_EQ(array.n_buffers, 3);
+  array.release(&array);
+
+  EXPECT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_DICTIONARY), EINVAL);
+  EXPECT_EQ(array.release, nullptr);
+  EXPECT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_EXTENSION), EINVAL);
+  EXPECT_EQ(array.release, nullptr);
+}
+
+TEST(ArrayTest, ArrayBuildInt32) {
+  struct ArrowArray array;
+  struct ArrowError error;
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_INT32), NANOARROW_OK);
+
+  // Build the validity buffer with a bitmap that is moved into the array
+  struct ArrowBitmap bitmap;
+  ArrowBitmapInit(&bitmap);
+  ASSERT_EQ(ArrowBitmapAppend(&bitmap, 1, 2), NANOARROW_OK);
+  ASSERT_EQ(ArrowBitmapAppend(&bitmap, 0, 1), NANOARROW_OK);
+  ASSERT_EQ(ArrowArraySetBuffer(&array, 0, &bitmap.buffer), NANOARROW_OK);
+  EXPECT_EQ(bitmap.buffer.data, nullptr);
+
+  // ...and the data buffer in place
+  struct ArrowBuffer* data_buffer = ArrowArrayBuffer(&array, 1);
+  ASSERT_EQ(ArrowBufferAppendInt32(data_buffer, 1), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppendInt32(data_buffer, 2), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppendInt32(data_buffer, 0), NANOARROW_OK);
+
+  array.length = 3;
+  array.null_count = 1;
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+
+  // The exported buffers are the built buffers
+  EXPECT_EQ(array.buffers[0], ArrowArrayBuffer(&array, 0)->data);
+  EXPECT_EQ(array.buffers[1], data_buffer->data);
+
+  const uint8_t* validity = reinterpret_cast<const uint8_t*>(array.buffers[0]);
+  const int32_t* values = reinterpret_cast<const int32_t*>(array.buffers[1]);
+  EXPECT_EQ(ArrowBitGet(validity, 0), 1);
+  EXPECT_EQ(ArrowBitGet(validity, 1), 1);
+  EXPECT_EQ(ArrowBitGet(validity, 2), 0);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[1], 2);
+
+  // Buffers can keep growing as long as the array is finished again
+  ASSERT_EQ(ArrowBufferReserve(data_buffer, 1024 * 1024), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+  EXPECT_EQ(array.buffers[1], data_buffer->data);
+  values = reinterpret_cast<const int32_t*>(array.buffers[1]);
+  EXPECT_EQ(values[1], 2);
+
+  ArrowBitmapReset(&bitmap);
+  array.release(&array);
+  EXPECT_EQ(array.release, nullptr);
+}
+
+TEST(ArrayTest, ArrayBuildEmpty) {
+  struct ArrowArray array;
+  struct ArrowError error;
+
+  // Empty offset and data buffers still point somewhere, but an absent
+  // validity buffer stays NULL
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_STRING), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+  EXPECT_EQ(array.buffers[0], nullptr);
+  EXPECT_NE(array.buffers[1], nullptr);
+  EXPECT_NE(array.buffers[2], nullptr);
+  EXPECT_EQ(reinterpret_cast<const int32_t*>(array.buffers[1])[0], 0);
+  array.release(&array);
+
+  // Union type ids are not a validity buffer
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_SPARSE_UNION), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+  EXPECT_NE(array.buffers[0], nullptr);
+  array.release(&array);
+}
+
+TEST(ArrayTest, ArrayBuildString) {
+  struct ArrowArray array;
+  struct ArrowError error;
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_STRING), NANOARROW_OK);
+
+  struct ArrowBuffer* offsets = ArrowArrayBuffer(&array, 1);
+  struct ArrowBuffer* data = ArrowArrayBuffer(&array, 2);
+  ASSERT_EQ(ArrowBufferAppendInt32(offsets, 0), NANOARROW_OK);
+  for (std::string item : {"abc", "", "defg"}) {
+    ASSERT_EQ(ArrowBufferAppend(data, item.data(), item.size()), NANOARROW_OK);
+    ASSERT_EQ(ArrowBufferAppendInt32(offsets, static_cast<int32_t>(data->size_bytes)),
+              NANOARROW_OK);
+  }
+
+  array.length = 3;
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+  EXPECT_EQ(array.buffers[0], nullptr);
+
+  const int32_t* offsets_out = reinterpret_cast<const int32_t*>(array.buffers[1]);
+  const char* data_out = reinterpret_cast<const char*>(array.buffers[2]);
+  EXPECT_EQ(offsets_out[3], 7);
+  EXPECT_EQ(std::string(data_out + offsets_out[2], offsets_out[3] - offsets_out[2]),
+            "defg");
+
+  array.release(&array);
+}
+
+static void FreeVector(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                       int64_t size) {
+  delete reinterpret_cast<std::vector<int64_t>*>(allocator->private_data);
+}
+
+TEST(ArrayTest, ArraySetBufferWrap) {
+  struct ArrowArray array;
+  struct ArrowError error;
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_INT64), NANOARROW_OK);
+
+  // Memory owned elsewhere is exported without copying and released with the array
+  auto values = new std::vector<int64_t>({1, 2, 3});
+  struct ArrowBufferAllocator deallocator = ArrowBufferDeallocator(&FreeVector, values);
+  struct ArrowBuffer buffer;
+  ArrowBufferInitWrap(&buffer, reinterpret_cast<uint8_t*>(values->data()),
+                      values->size() * sizeof(int64_t), &deallocator);
+
+  ASSERT_EQ(ArrowArraySetBuffer(&array, 1, &buffer), NANOARROW_OK);
+  array.length = 3;
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+  EXPECT_EQ(array.buffers[1], values->data());
+
+  // Replacing a buffer releases the previous one
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferAppendInt64(&buffer, 4), NANOARROW_OK);
+  ASSERT_EQ(ArrowArraySetBuffer(&array, 1, &buffer), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<const int64_t*>(array.buffers[1])[0], 4);
+
+  EXPECT_EQ(ArrowArraySetBuffer(&array, 2, &buffer), EINVAL);
+  array.release(&array);
+
+  // Arrays that were not built by nanoarrow have no buffers to set
+  struct ArrowArray not_ours;
+  memset(&not_ours, 0, sizeof(struct ArrowArray));
+  EXPECT_EQ(ArrowArrayBuffer(&not_ours, 0), nullptr);
+  EXPECT_EQ(ArrowArraySetBuffer(&not_ours, 0, &buffer), EINVAL);
+  EXPECT_EQ(ArrowArrayFinishBuilding(&not_ours, &error), EINVAL);
+  EXPECT_STREQ(ArrowErrorMessage(&error),
+               "Expected array initialized with ArrowArrayInit()");
+}
+
+TEST(ArrayTest, ArrayChildrenAndDictionary) {
+  struct ArrowArray array;
+  struct ArrowError error;
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayAllocateChildren(&array, 2), NANOARROW_OK);
+  EXPECT_EQ(array.n_children, 2);
+  EXPECT_EQ(array.children[0]->release, nullptr);
+  EXPECT_EQ(ArrowArrayAllocateChildren(&array, 2), EEXIST);
+
+  // Children have to be initialized before the array can be finished
+  ASSERT_EQ(ArrowArrayInit(array.children[0], NANOARROW_TYPE_INT32), NANOARROW_OK);
+  EXPECT_EQ(ArrowArrayFinishBuilding(&array, &error), EINVAL);
+  EXPECT_STREQ(ArrowErrorMessage(&error), "Expected valid array at array->children[1]");
+
+  // ...and finishing the parent finishes the children
+  ASSERT_EQ(ArrowArrayInit(array.children[1], NANOARROW_TYPE_INT32), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayAllocateDictionary(array.children[1]), NANOARROW_OK);
+  EXPECT_EQ(ArrowArrayAllocateDictionary(array.children[1]), EEXIST);
+  EXPECT_EQ(ArrowArrayFinishBuilding(&array, &error), EINVAL);
+  EXPECT_STREQ(ArrowErrorMessage(&error), "Expected valid array at array->dictionary");
+
+  ASSERT_EQ(ArrowArrayInit(array.children[1]->dictionary, NANOARROW_TYPE_STRING),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppendInt32(ArrowArrayBuffer(array.children[0], 1), 123),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+
+  EXPECT_EQ(reinterpret_cast<const int32_t*>(array.children[0]->buffers[1])[0], 123);
+  EXPECT_NE(array.children[1]->buffers[1], nullptr);
+  EXPECT_NE(array.children[1]->dictionary->buffers[2], nullptr);
+
+  // Releasing the parent releases everything
+  array.release(&array);
+  EXPECT_EQ(array.release, nullptr);
+}
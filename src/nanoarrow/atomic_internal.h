@@ -0,0 +1,101 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifndef NANOARROW_ATOMIC_INTERNAL_H_INCLUDED
+#define NANOARROW_ATOMIC_INTERNAL_H_INCLUDED
+
+#include <stdint.h>
+
+// Minimal atomic operations on plain int64_t values for use in the .c files.
+// These are not part of the public API: public structures keep plain int64_t
+// members so that nanoarrow.h can be included from C and C++ alike.
+//
+// The statistics, limit, and pool allocators, shared buffers, and schema
+// blocks document themselves as thread-safe, so there is deliberately no
+// non-atomic fallback: compilers without GNU builtins, MSVC intrinsics, or
+// C11 atomics fail to compile this file instead of racing at run time.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NANOARROW_ATOMIC_GNUC
+#elif defined(_MSC_VER)
+#define NANOARROW_ATOMIC_MSVC
+#include <intrin.h>
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+    !defined(__STDC_NO_ATOMICS__)
+#define NANOARROW_ATOMIC_C11
+#include <stdatomic.h>
+// The plain int64_t values are operated on through _Atomic pointers
+_Static_assert(sizeof(_Atomic int64_t) == sizeof(int64_t),
+               "_Atomic int64_t must have the same size as int64_t");
+#else
+#error "nanoarrow requires GNU atomic builtins, MSVC intrinsics, or C11 <stdatomic.h>"
+#endif
+
+static inline int64_t ArrowAtomicLoad(int64_t* value) {
+#if defined(NANOARROW_ATOMIC_GNUC)
+  return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#elif defined(NANOARROW_ATOMIC_MSVC)
+  return _InterlockedCompareExchange64((volatile __int64*)value, 0, 0);
+#else
+  return atomic_load_explicit((_Atomic int64_t*)value, memory_order_acquire);
+#endif
+}
+
+// Adds delta to value and returns the result
+static inline int64_t ArrowAtomicAdd(int64_t* value, int64_t delta) {
+#if defined(NANOARROW_ATOMIC_GNUC)
+  return __atomic_add_fetch(value, delta, __ATOMIC_ACQ_REL);
+#elif defined(NANOARROW_ATOMIC_MSVC)
+  return _InterlockedExchangeAdd64((volatile __int64*)value, delta) + delta;
+#else
+  return atomic_fetch_add_explicit((_Atomic int64_t*)value, delta,
+                                   memory_order_acq_rel) +
+         delta;
+#endif
+}
+
+// Sets value to desired if it is equal to *expected and returns non-zero;
+// otherwise, stores the current value in *expected and returns zero.
+static inline int ArrowAtomicCompareExchange(int64_t* value, int64_t* expected,
+                                             int64_t desired) {
+#if defined(NANOARROW_ATOMIC_GNUC)
+  return __atomic_compare_exchange_n(value, expected, desired, 0, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE);
+#elif defined(NANOARROW_ATOMIC_MSVC)
+  int64_t previous =
+      _InterlockedCompareExchange64((volatile __int64*)value, desired, *expected);
+  if (previous == *expected) {
+    return 1;
+  }
+
+  *expected = previous;
+  return 0;
+#else
+  return atomic_compare_exchange_strong_explicit((_Atomic int64_t*)value, expected,
+                                                 desired, memory_order_acq_rel,
+                                                 memory_order_acquire);
+#endif
+}
+
+// Raises value to at least candidate
+static inline void ArrowAtomicMax(int64_t* value, int64_t candidate) {
+  int64_t current = ArrowAtomicLoad(value);
+  while (current < candidate && !ArrowAtomicCompareExchange(value, &current, candidate)) {
+  }
+}
+
+#endif
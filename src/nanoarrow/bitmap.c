@@ -0,0 +1,371 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <string.h>
+
+// Bit counting uses AVX-512 VPOPCNTDQ or AVX2 when the build targets them. A
+// baseline x86 build can assume neither AVX2 nor even POPCNT (without which
+// __builtin_popcountll() is a library call that counts about ten times more
+// slowly), so there both are compiled with target attributes and selected at
+// run time.
+#if defined(__AVX512VPOPCNTDQ__) && defined(__AVX512F__)
+#define NANOARROW_BITMAP_COUNT_AVX512
+#elif defined(__AVX2__)
+#define NANOARROW_BITMAP_COUNT_AVX2
+#define NANOARROW_BITMAP_TARGET_AVX2
+#elif (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define NANOARROW_BITMAP_COUNT_DISPATCH
+#define NANOARROW_BITMAP_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define NANOARROW_BITMAP_TARGET_POPCNT __attribute__((target("popcnt")))
+#endif
+
+// The word-at-a-time count is inlined into each target-specific function so
+// that it is compiled with that function's instruction set
+#if defined(NANOARROW_BITMAP_COUNT_DISPATCH)
+#define NANOARROW_BITMAP_ALWAYS_INLINE __attribute__((always_inline))
+#else
+#define NANOARROW_BITMAP_ALWAYS_INLINE
+#endif
+
+#if defined(__AVX2__) || defined(__AVX512VPOPCNTDQ__) || \
+    defined(NANOARROW_BITMAP_COUNT_DISPATCH)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "nanoarrow.h"
+
+void ArrowBitmapInit(struct ArrowBitmap* bitmap) {
+  ArrowBufferInit(&bitmap->buffer);
+  bitmap->size_bits = 0;
+  bitmap->null_count = 0;
+}
+
+ArrowErrorCode ArrowBitmapReserve(struct ArrowBitmap* bitmap,
+                                  int64_t additional_size_bits) {
+  int64_t min_capacity_bits = bitmap->size_bits + additional_size_bits;
+  if (min_capacity_bits <= (bitmap->buffer.capacity_bytes * 8)) {
+    return NANOARROW_OK;
+  }
+
+  int64_t old_capacity_bytes = bitmap->buffer.capacity_bytes;
+  int result = ArrowBufferReserve(
+      &bitmap->buffer, ArrowBytesForBits(min_capacity_bits) - bitmap->buffer.size_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  // Keep the bits past the end of the bitmap zeroed so that appending unset
+  // bits never has to write anything
+  memset(bitmap->buffer.data + old_capacity_bytes, 0,
+         bitmap->buffer.capacity_bytes - old_capacity_bytes);
+  return NANOARROW_OK;
+}
+
+void ArrowBitmapAppendUnsafe(struct ArrowBitmap* bitmap, uint8_t bits_are_set,
+                             int64_t length) {
+  if (length <= 0) {
+    return;
+  }
+
+  int64_t start = bitmap->size_bits;
+  int64_t end = start + length;
+  bitmap->size_bits = end;
+  bitmap->buffer.size_bytes = ArrowBytesForBits(end);
+
+  if (!bits_are_set) {
+    bitmap->null_count += length;
+    return;
+  }
+
+  uint8_t* bits = bitmap->buffer.data;
+
+  // Bits up to the first byte boundary
+  while (start < end && (start & 7) != 0) {
+    ArrowBitSet(bits, start++);
+  }
+
+  // Whole bytes
+  int64_t n_bytes = (end - start) >> 3;
+  memset(bits + (start >> 3), 0xff, n_bytes);
+  start += n_bytes * 8;
+
+  // Bits after the last byte boundary
+  while (start < end) {
+    ArrowBitSet(bits, start++);
+  }
+}
+
+ArrowErrorCode ArrowBitmapAppend(struct ArrowBitmap* bitmap, uint8_t bits_are_set,
+                                 int64_t length) {
+  int result = ArrowBitmapReserve(bitmap, length);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  ArrowBitmapAppendUnsafe(bitmap, bits_are_set, length);
+  return NANOARROW_OK;
+}
+
+void ArrowBitmapAppendInt8Unsafe(struct ArrowBitmap* bitmap, const int8_t* values,
+                                 int64_t n_values) {
+  if (n_values <= 0) {
+    return;
+  }
+
+  int64_t i_from = bitmap->size_bits;
+  ArrowBitsPackInt8(bitmap->buffer.data, i_from, n_values, values);
+
+  bitmap->size_bits += n_values;
+  bitmap->buffer.size_bytes = ArrowBytesForBits(bitmap->size_bits);
+  bitmap->null_count +=
+      n_values - ArrowBitCountSet(bitmap->buffer.data, i_from, n_values);
+}
+
+ArrowErrorCode ArrowBitmapAppendInt8(struct ArrowBitmap* bitmap, const int8_t* values,
+                                     int64_t n_values) {
+  int result = ArrowBitmapReserve(bitmap, n_values);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  ArrowBitmapAppendInt8Unsafe(bitmap, values, n_values);
+  return NANOARROW_OK;
+}
+
+void ArrowBitmapReset(struct ArrowBitmap* bitmap) {
+  ArrowBufferReset(&bitmap->buffer);
+  bitmap->size_bits = 0;
+  bitmap->null_count = 0;
+}
+
+static inline NANOARROW_BITMAP_ALWAYS_INLINE int64_t
+ArrowBitmapPopcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#else
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (int64_t)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Counts the set bits in n_bytes whole bytes one 64-bit word at a time. The
+// order of the bytes in a word does not change how many bits are set in it, so
+// words are loaded in native byte order.
+static inline NANOARROW_BITMAP_ALWAYS_INLINE int64_t
+ArrowBitmapCountSetWords(const uint8_t* bytes, int64_t n_bytes) {
+  int64_t count = 0;
+
+  uint64_t word;
+  for (; n_bytes >= 8; n_bytes -= 8, bytes += 8) {
+    memcpy(&word, bytes, sizeof(uint64_t));
+    count += ArrowBitmapPopcount64(word);
+  }
+
+  for (; n_bytes > 0; n_bytes--, bytes++) {
+    count += ArrowBitmapPopcount64(*bytes);
+  }
+
+  return count;
+}
+
+#if defined(NANOARROW_BITMAP_COUNT_AVX2) || defined(NANOARROW_BITMAP_COUNT_DISPATCH)
+static NANOARROW_BITMAP_TARGET_AVX2 int64_t
+ArrowBitmapCountSetBytesAvx2(const uint8_t* bytes, int64_t n_bytes) {
+  // Look up the number of set bits in each nibble and sum the bytes of each
+  // lane with a sum of absolute differences against zero
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2,
+                       2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i acc = _mm256_setzero_si256();
+  for (; n_bytes >= 32; n_bytes -= 32, bytes += 32) {
+    __m256i chunk = _mm256_loadu_si256((const __m256i*)bytes);
+    __m256i low = _mm256_and_si256(chunk, low_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low_mask);
+    __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low),
+                                     _mm256_shuffle_epi8(lookup, high));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+  }
+
+  int64_t lanes[4];
+  _mm256_storeu_si256((__m256i*)lanes, acc);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+         ArrowBitmapCountSetWords(bytes, n_bytes);
+}
+#endif
+
+#if defined(NANOARROW_BITMAP_COUNT_DISPATCH)
+static NANOARROW_BITMAP_TARGET_POPCNT int64_t
+ArrowBitmapCountSetBytesPopcnt(const uint8_t* bytes, int64_t n_bytes) {
+  return ArrowBitmapCountSetWords(bytes, n_bytes);
+}
+#endif
+
+// Counts the set bits in n_bytes whole bytes
+static int64_t ArrowBitmapCountSetBytes(const uint8_t* bytes, int64_t n_bytes) {
+#if defined(NANOARROW_BITMAP_COUNT_AVX512)
+  __m512i acc = _mm512_setzero_si512();
+  for (; n_bytes >= 64; n_bytes -= 64, bytes += 64) {
+    __m512i chunk = _mm512_loadu_si512((const void*)bytes);
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(chunk));
+  }
+
+  return _mm512_reduce_add_epi64(acc) + ArrowBitmapCountSetWords(bytes, n_bytes);
+#elif defined(NANOARROW_BITMAP_COUNT_AVX2)
+  return ArrowBitmapCountSetBytesAvx2(bytes, n_bytes);
+#elif defined(NANOARROW_BITMAP_COUNT_DISPATCH)
+  if (__builtin_cpu_supports("avx2")) {
+    return ArrowBitmapCountSetBytesAvx2(bytes, n_bytes);
+  } else if (__builtin_cpu_supports("popcnt")) {
+    return ArrowBitmapCountSetBytesPopcnt(bytes, n_bytes);
+  } else {
+    return ArrowBitmapCountSetWords(bytes, n_bytes);
+  }
+#else
+  return ArrowBitmapCountSetWords(bytes, n_bytes);
+#endif
+}
+
+int64_t ArrowBitCountSet(const uint8_t* bits, int64_t i_from, int64_t length) {
+  if (length <= 0) {
+    return 0;
+  }
+
+  int64_t i_end = i_from + length;
+  int64_t first_byte = i_from >> 3;
+  int64_t last_byte = i_end >> 3;
+  int head_bits = (int)(i_from & 7);
+  int tail_bits = (int)(i_end & 7);
+
+  // The range starts and ends within the same byte
+  if (first_byte == last_byte) {
+    uint8_t mask = (uint8_t)(((1 << length) - 1) << head_bits);
+    return ArrowBitmapPopcount64(bits[first_byte] & mask);
+  }
+
+  int64_t count = 0;
+
+  // Bits up to the first byte boundary
+  if (head_bits != 0) {
+    count += ArrowBitmapPopcount64(bits[first_byte] >> head_bits);
+    first_byte++;
+  }
+
+  count += ArrowBitmapCountSetBytes(bits + first_byte, last_byte - first_byte);
+
+  // Bits after the last byte boundary
+  if (tail_bits != 0) {
+    count += ArrowBitmapPopcount64(bits[last_byte] & ((1 << tail_bits) - 1));
+  }
+
+  return count;
+}
+
+// Packs 8 * n_bytes values into n_bytes whole bytes
+static void ArrowBitsPackInt8Bytes(uint8_t* bytes, int64_t n_bytes,
+                                   const int8_t* values) {
+#if defined(__SSE2__)
+  // The mask of the bytes that are zero has bit i set if values[i] == 0,
+  // which is the complement of the bitmap for 16 values
+  const __m128i zero = _mm_setzero_si128();
+  for (; n_bytes >= 2; n_bytes -= 2, bytes += 2, values += 16) {
+    __m128i chunk = _mm_loadu_si128((const __m128i*)values);
+    int is_zero = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+    bytes[0] = (uint8_t)~is_zero;
+    bytes[1] = (uint8_t)(~is_zero >> 8);
+  }
+#endif
+
+  for (; n_bytes > 0; n_bytes--, bytes++, values += 8) {
+    uint8_t byte = 0;
+    for (int j = 0; j < 8; j++) {
+      byte |= (uint8_t)((values[j] != 0) << j);
+    }
+
+    *bytes = byte;
+  }
+}
+
+// Unpacks n_bytes whole bytes into 8 * n_bytes values
+static void ArrowBitsUnpackInt8Bytes(const uint8_t* bytes, int64_t n_bytes,
+                                     int8_t* out) {
+#if defined(__SSE2__)
+  // Broadcast each byte to eight lanes and test one bit per lane
+  const __m128i bit_masks =
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2, 4, 8, 16, 32, 64, (char)128);
+  const __m128i ones = _mm_set1_epi8(1);
+  for (; n_bytes >= 2; n_bytes -= 2, bytes += 2, out += 16) {
+    __m128i chunk = _mm_unpacklo_epi64(_mm_set1_epi8((char)bytes[0]),
+                                       _mm_set1_epi8((char)bytes[1]));
+    __m128i is_set = _mm_cmpeq_epi8(_mm_and_si128(chunk, bit_masks), bit_masks);
+    _mm_storeu_si128((__m128i*)out, _mm_and_si128(is_set, ones));
+  }
+#endif
+
+  for (; n_bytes > 0; n_bytes--, bytes++, out += 8) {
+    for (int j = 0; j < 8; j++) {
+      out[j] = (*bytes >> j) & 1;
+    }
+  }
+}
+
+void ArrowBitsPackInt8(uint8_t* bits, int64_t i_from, int64_t length,
+                       const int8_t* values) {
+  int64_t i = i_from;
+  int64_t i_end = i_from + length;
+
+  // Bits up to the first byte boundary
+  while (i < i_end && (i & 7) != 0) {
+    ArrowBitSetTo(bits, i++, *values++ != 0);
+  }
+
+  int64_t n_bytes = (i_end - i) >> 3;
+  ArrowBitsPackInt8Bytes(bits + (i >> 3), n_bytes, values);
+  values += n_bytes * 8;
+  i += n_bytes * 8;
+
+  // Bits after the last byte boundary
+  while (i < i_end) {
+    ArrowBitSetTo(bits, i++, *values++ != 0);
+  }
+}
+
+void ArrowBitsUnpackInt8(const uint8_t* bits, int64_t i_from, int64_t length,
+                         int8_t* out) {
+  int64_t i = i_from;
+  int64_t i_end = i_from + length;
+
+  // Bits up to the first byte boundary
+  while (i < i_end && (i & 7) != 0) {
+    *out++ = ArrowBitGet(bits, i++);
+  }
+
+  int64_t n_bytes = (i_end - i) >> 3;
+  ArrowBitsUnpackInt8Bytes(bits + (i >> 3), n_bytes, out);
+  out += n_bytes * 8;
+  i += n_bytes * 8;
+
+  // Bits after the last byte boundary
+  while (i < i_end) {
+    *out++ = ArrowBitGet(bits, i++);
+  }
+}
@@ -0,0 +1,78 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+// A validity bitmap with about 90% of its bits set
+static std::vector<uint8_t> RandomBitmap(int64_t n_bytes) {
+  std::mt19937 rng(1234);
+  std::bernoulli_distribution valid(0.9);
+  std::vector<uint8_t> bits(n_bytes);
+  for (int64_t i = 0; i < n_bytes * 8; i++) {
+    ArrowBitSetTo(bits.data(), i, valid(rng));
+  }
+
+  return bits;
+}
+
+// The bit-at-a-time loop that ArrowBitCountSet() replaces
+static void BM_BitCountSetScalar(benchmark::State& state) {
+  std::vector<uint8_t> bits = RandomBitmap(state.range(0));
+  int64_t n_bits = state.range(0) * 8;
+
+  for (auto _ : state) {
+    int64_t count = 0;
+    for (int64_t i = 0; i < n_bits; i++) {
+      count += ArrowBitGet(bits.data(), i);
+    }
+    benchmark::DoNotOptimize(count);
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_BitCountSet(benchmark::State& state) {
+  std::vector<uint8_t> bits = RandomBitmap(state.range(0));
+  int64_t n_bits = state.range(0) * 8;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ArrowBitCountSet(bits.data(), 0, n_bits));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// A slice that starts and ends in the middle of a byte
+static void BM_BitCountSetOffset(benchmark::State& state) {
+  std::vector<uint8_t> bits = RandomBitmap(state.range(0));
+  int64_t n_bits = state.range(0) * 8 - 6;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ArrowBitCountSet(bits.data(), 3, n_bits));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_BitCountSetScalar)->Arg(1 << 12)->Arg(1 << 20);
+BENCHMARK(BM_BitCountSet)->Arg(64)->Arg(1 << 12)->Arg(1 << 20)->Arg(1 << 26);
+BENCHMARK(BM_BitCountSetOffset)->Arg(64)->Arg(1 << 12)->Arg(1 << 20);
@@ -0,0 +1,237 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+// Checks a bitmap against one bool per bit, including that the bits past its
+// end are zero
+static void ExpectBitmapEquals(struct ArrowBitmap* bitmap,
+                               const std::vector<bool>& expected) {
+  ASSERT_EQ(bitmap->size_bits, static_cast<int64_t>(expected.size()));
+  ASSERT_EQ(bitmap->buffer.size_bytes, ArrowBytesForBits(expected.size()));
+
+  int64_t null_count = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(ArrowBitGet(bitmap->buffer.data, i), expected[i]) << "bit " << i;
+    null_count += !expected[i];
+  }
+
+  for (int64_t i = expected.size(); i < bitmap->buffer.capacity_bytes * 8; i++) {
+    EXPECT_EQ(ArrowBitGet(bitmap->buffer.data, i), 0) << "bit " << i;
+  }
+
+  EXPECT_EQ(bitmap->null_count, null_count);
+}
+
+TEST(BitmapTest, BitmapTestBitHelpers) {
+  EXPECT_EQ(ArrowBytesForBits(0), 0);
+  EXPECT_EQ(ArrowBytesForBits(1), 1);
+  EXPECT_EQ(ArrowBytesForBits(8), 1);
+  EXPECT_EQ(ArrowBytesForBits(9), 2);
+
+  uint8_t bits[2] = {0, 0};
+  ArrowBitSet(bits, 0);
+  ArrowBitSet(bits, 9);
+  EXPECT_EQ(bits[0], 0x01);
+  EXPECT_EQ(bits[1], 0x02);
+  EXPECT_EQ(ArrowBitGet(bits, 0), 1);
+  EXPECT_EQ(ArrowBitGet(bits, 1), 0);
+  EXPECT_EQ(ArrowBitGet(bits, 9), 1);
+
+  ArrowBitClear(bits, 0);
+  EXPECT_EQ(bits[0], 0x00);
+
+  ArrowBitSetTo(bits, 7, 1);
+  EXPECT_EQ(bits[0], 0x80);
+  ArrowBitSetTo(bits, 7, 0);
+  EXPECT_EQ(bits[0], 0x00);
+}
+
+TEST(BitmapTest, BitmapTestAppendBit) {
+  struct ArrowBitmap bitmap;
+  ArrowBitmapInit(&bitmap);
+  EXPECT_EQ(bitmap.size_bits, 0);
+  EXPECT_EQ(bitmap.null_count, 0);
+
+  std::vector<bool> expected;
+  for (int i = 0; i < 100; i++) {
+    bool bit_is_set = (i % 3) != 0;
+    ASSERT_EQ(ArrowBitmapAppendBit(&bitmap, bit_is_set), NANOARROW_OK);
+    expected.push_back(bit_is_set);
+  }
+
+  ExpectBitmapEquals(&bitmap, expected);
+
+  ArrowBitmapReset(&bitmap);
+  EXPECT_EQ(bitmap.buffer.data, nullptr);
+  EXPECT_EQ(bitmap.size_bits, 0);
+  EXPECT_EQ(bitmap.null_count, 0);
+}
+
+TEST(BitmapTest, BitmapTestAppend) {
+  struct ArrowBitmap bitmap;
+  ArrowBitmapInit(&bitmap);
+
+  // Runs that start and end in the middle of a byte or span whole bytes
+  std::vector<bool> expected;
+  std::vector<int64_t> lengths = {0, 3, 1, 4, 13, 64, 7, 100, 2};
+  bool bits_are_set = true;
+  for (int64_t length : lengths) {
+    ASSERT_EQ(ArrowBitmapAppend(&bitmap, bits_are_set, length), NANOARROW_OK);
+    expected.insert(expected.end(), length, bits_are_set);
+    bits_are_set = !bits_are_set;
+  }
+
+  ExpectBitmapEquals(&bitmap, expected);
+  ArrowBitmapReset(&bitmap);
+
+  // A single reservation followed by unchecked appends
+  ArrowBitmapInit(&bitmap);
+  ASSERT_EQ(ArrowBitmapReserve(&bitmap, 20), NANOARROW_OK);
+  int64_t capacity = bitmap.buffer.capacity_bytes;
+  ArrowBitmapAppendUnsafe(&bitmap, 1, 10);
+  ArrowBitmapAppendBitUnsafe(&bitmap, 0);
+  ArrowBitmapAppendUnsafe(&bitmap, 1, 9);
+  EXPECT_EQ(bitmap.buffer.capacity_bytes, capacity);
+
+  expected.assign(20, true);
+  expected[10] = false;
+  ExpectBitmapEquals(&bitmap, expected);
+  ArrowBitmapReset(&bitmap);
+}
+
+TEST(BitmapTest, BitmapTestAppendInt8) {
+  std::vector<int8_t> values(1000);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = (i % 7 == 0) ? 0 : static_cast<int8_t>(i);
+  }
+
+  // Starting at every offset within a byte
+  for (int offset = 0; offset < 8; offset++) {
+    for (int64_t n_values : {0, 1, 5, 8, 9, 100, 1000}) {
+      struct ArrowBitmap bitmap;
+      ArrowBitmapInit(&bitmap);
+      ASSERT_EQ(ArrowBitmapAppend(&bitmap, 1, offset), NANOARROW_OK);
+      ASSERT_EQ(ArrowBitmapAppendInt8(&bitmap, values.data(), n_values), NANOARROW_OK);
+
+      std::vector<bool> expected(offset, true);
+      for (int64_t i = 0; i < n_values; i++) {
+        expected.push_back(values[i] != 0);
+      }
+
+      ExpectBitmapEquals(&bitmap, expected);
+      ArrowBitmapReset(&bitmap);
+    }
+  }
+}
+
+static int64_t CountSetReference(const uint8_t* bits, int64_t i_from, int64_t length) {
+  int64_t count = 0;
+  for (int64_t i = i_from; i < (i_from + length); i++) {
+    count += ArrowBitGet(bits, i);
+  }
+
+  return count;
+}
+
+TEST(BitmapTest, BitmapTestCountSet) {
+  EXPECT_EQ(ArrowBitCountSet(nullptr, 0, 0), 0);
+
+  uint8_t byte = 0xb5;
+  EXPECT_EQ(ArrowBitCountSet(&byte, 0, 8), 5);
+  EXPECT_EQ(ArrowBitCountSet(&byte, 0, 1), 1);
+  EXPECT_EQ(ArrowBitCountSet(&byte, 1, 1), 0);
+  EXPECT_EQ(ArrowBitCountSet(&byte, 2, 3), 2);
+  EXPECT_EQ(ArrowBitCountSet(&byte, 7, 1), 1);
+
+  // Enough bytes to exercise any vectorized path and its remainders
+  std::vector<uint8_t> bits(1000);
+  uint32_t state = 12345;
+  for (uint8_t& value : bits) {
+    state = state * 1103515245 + 12345;
+    value = static_cast<uint8_t>(state >> 16);
+  }
+
+  for (int64_t i_from : {0, 1, 3, 7, 8, 9, 63, 64, 65, 255, 513}) {
+    for (int64_t length : {0, 1, 2, 7, 8, 15, 64, 100, 255, 256, 257, 512, 1000, 7000}) {
+      EXPECT_EQ(ArrowBitCountSet(bits.data(), i_from, length),
+                CountSetReference(bits.data(), i_from, length))
+          << "i_from " << i_from << " length " << length;
+    }
+  }
+
+  std::vector<uint8_t> all_set(100, 0xff);
+  EXPECT_EQ(ArrowBitCountSet(all_set.data(), 5, 790), 790);
+  std::vector<uint8_t> none_set(100, 0);
+  EXPECT_EQ(ArrowBitCountSet(none_set.data(), 5, 790), 0);
+}
+
+TEST(BitmapTest, BitmapTestCountSetNullCount) {
+  struct ArrowBitmap bitmap;
+  ArrowBitmapInit(&bitmap);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(ArrowBitmapAppendBit(&bitmap, (i % 5) != 0), NANOARROW_OK);
+  }
+
+  EXPECT_EQ(bitmap.size_bits - ArrowBitCountSet(bitmap.buffer.data, 0, bitmap.size_bits),
+            bitmap.null_count);
+  ArrowBitmapReset(&bitmap);
+}
+
+TEST(BitmapTest, BitmapTestPackUnpack) {
+  std::vector<int8_t> values(300);
+  uint32_t state = 6789;
+  for (int8_t& value : values) {
+    state = state * 1103515245 + 12345;
+    value = static_cast<int8_t>(state >> 16);
+    if (value < 0) {
+      value = 0;
+    }
+  }
+
+  for (int64_t i_from : {0, 1, 5, 8, 13, 64}) {
+    for (int64_t length : {0, 1, 7, 8, 9, 16, 17, 33, 100, 300}) {
+      // Bits outside the packed range keep their value
+      std::vector<uint8_t> bits(50, 0xa5);
+      ArrowBitsPackInt8(bits.data(), i_from, length, values.data());
+
+      for (int64_t i = 0; i < static_cast<int64_t>(bits.size()) * 8; i++) {
+        uint8_t expected;
+        if (i >= i_from && i < (i_from + length)) {
+          expected = values[i - i_from] != 0;
+        } else {
+          expected = (0xa5 >> (i % 8)) & 1;
+        }
+
+        ASSERT_EQ(ArrowBitGet(bits.data(), i), expected)
+            << "i_from " << i_from << " length " << length << " bit " << i;
+      }
+
+      std::vector<int8_t> unpacked(length + 1, 42);
+      ArrowBitsUnpackInt8(bits.data(), i_from, length, unpacked.data());
+      for (int64_t i = 0; i < length; i++) {
+        ASSERT_EQ(unpacked[i], values[i] != 0)
+            << "i_from " << i_from << " length " << length << " value " << i;
+      }
+      EXPECT_EQ(unpacked[length], 42);
+    }
+  }
+}
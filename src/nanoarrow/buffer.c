@@ -20,8 +20,20 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "atomic_internal.h"
 #include "nanoarrow.h"
 
+// Appends smaller than this are copied with memcpy() by
+// ArrowBufferAppendNonTemporal() because the data is probably about to be
+// read again and is cheap to keep in cache
+#ifndef NANOARROW_NON_TEMPORAL_THRESHOLD_BYTES
+#define NANOARROW_NON_TEMPORAL_THRESHOLD_BYTES (1024 * 1024)
+#endif
+
 static int64_t ArrowGrowByFactor(int64_t current_capacity, int64_t new_capacity) {
   int64_t doubled_capacity = current_capacity * 2;
   if (doubled_capacity > new_capacity) {
@@ -31,27 +43,96 @@ static int64_t ArrowGrowByFactor(int64_t current_capacity, int64_t new_capacity)
   }
 }
 
+static int64_t ArrowGrowByPolicy(const struct ArrowBufferGrowthPolicy* policy,
+                                 int64_t current_capacity, int64_t new_capacity) {
+  double grown_capacity;
+  if (policy->linear_threshold_bytes > 0 &&
+      current_capacity >= policy->linear_threshold_bytes) {
+    grown_capacity = (double)current_capacity + (double)policy->linear_increment_bytes;
+  } else {
+    grown_capacity = (double)current_capacity * policy->growth_factor;
+  }
+
+  // Overallocating is skipped if the grown capacity can't be represented
+  int64_t capacity = new_capacity;
+  if (grown_capacity > (double)capacity && grown_capacity < (double)INT64_MAX) {
+    capacity = (int64_t)grown_capacity;
+  }
+
+  if (policy->min_capacity_bytes > capacity) {
+    capacity = policy->min_capacity_bytes;
+  }
+
+  if (policy->alignment_bytes > 1) {
+    int64_t remainder = capacity % policy->alignment_bytes;
+    if (remainder != 0 && capacity <= (INT64_MAX - policy->alignment_bytes)) {
+      capacity += policy->alignment_bytes - remainder;
+    }
+  }
+
+  return capacity;
+}
+
+static int64_t ArrowBufferGrow(struct ArrowBuffer* buffer, int64_t new_capacity) {
+  if (buffer->growth_policy == NULL) {
+    return ArrowGrowByFactor(buffer->capacity_bytes, new_capacity);
+  } else {
+    return ArrowGrowByPolicy(buffer->growth_policy, buffer->capacity_bytes, new_capacity);
+  }
+}
+
+void ArrowBufferGrowthPolicyInit(struct ArrowBufferGrowthPolicy* policy) {
+  policy->growth_factor = 2;
+  policy->min_capacity_bytes = 0;
+  policy->alignment_bytes = 0;
+  policy->linear_threshold_bytes = 0;
+  policy->linear_increment_bytes = 0;
+}
+
 void ArrowBufferInit(struct ArrowBuffer* buffer) {
   buffer->data = NULL;
   buffer->size_bytes = 0;
   buffer->capacity_bytes = 0;
-  buffer->allocator = ArrowBufferAllocatorDefault();
+  buffer->allocator = *ArrowBufferAllocatorDefault();
+  buffer->growth_policy = NULL;
+}
+
+void ArrowBufferInitWrap(struct ArrowBuffer* buffer, uint8_t* data, int64_t size_bytes,
+                         struct ArrowBufferAllocator* deallocator) {
+  buffer->data = data;
+  buffer->size_bytes = size_bytes;
+  buffer->capacity_bytes = size_bytes;
+  buffer->allocator = *deallocator;
+  buffer->growth_policy = NULL;
 }
 
 ArrowErrorCode ArrowBufferSetAllocator(struct ArrowBuffer* buffer,
                                        struct ArrowBufferAllocator* allocator) {
   if (buffer->data == NULL) {
-    buffer->allocator = allocator;
+    buffer->allocator = *allocator;
     return NANOARROW_OK;
   } else {
     return EINVAL;
   }
 }
 
+ArrowErrorCode ArrowBufferSetGrowthPolicy(struct ArrowBuffer* buffer,
+                                          const struct ArrowBufferGrowthPolicy* policy) {
+  if (policy != NULL &&
+      (!(policy->growth_factor >= 1) || policy->min_capacity_bytes < 0 ||
+       policy->alignment_bytes < 0 || policy->linear_threshold_bytes < 0 ||
+       (policy->linear_threshold_bytes > 0 && policy->linear_increment_bytes <= 0))) {
+    return EINVAL;
+  }
+
+  buffer->growth_policy = policy;
+  return NANOARROW_OK;
+}
+
 void ArrowBufferReset(struct ArrowBuffer* buffer) {
   if (buffer->data != NULL) {
-    buffer->allocator->free(buffer->allocator, (uint8_t*)buffer->data,
-                            buffer->capacity_bytes);
+    buffer->allocator.free(&buffer->allocator, (uint8_t*)buffer->data,
+                           buffer->capacity_bytes);
     buffer->data = NULL;
   }
 
@@ -72,14 +153,14 @@ ArrowErrorCode ArrowBufferResize(struct ArrowBuffer* buffer, int64_t new_capacit
   }
 
   if (new_capacity_bytes > buffer->capacity_bytes || shrink_to_fit) {
-    buffer->data = buffer->allocator->reallocate(
-        buffer->allocator, buffer->data, buffer->capacity_bytes, new_capacity_bytes);
-    if (buffer->data == NULL && new_capacity_bytes > 0) {
-      buffer->capacity_bytes = 0;
-      buffer->size_bytes = 0;
+    // A failed reallocation leaves the original allocation (and the buffer) intact
+    uint8_t* data = buffer->allocator.reallocate(
+        &buffer->allocator, buffer->data, buffer->capacity_bytes, new_capacity_bytes);
+    if (data == NULL && new_capacity_bytes > 0) {
       return ENOMEM;
     }
 
+    buffer->data = data;
     buffer->capacity_bytes = new_capacity_bytes;
   }
 
@@ -98,8 +179,7 @@ ArrowErrorCode ArrowBufferReserve(struct ArrowBuffer* buffer,
     return NANOARROW_OK;
   }
 
-  return ArrowBufferResize(
-      buffer, ArrowGrowByFactor(buffer->capacity_bytes, min_capacity_bytes), 0);
+  return ArrowBufferResize(buffer, ArrowBufferGrow(buffer, min_capacity_bytes), 0);
 }
 
 void ArrowBufferAppendUnsafe(struct ArrowBuffer* buffer, const void* data,
@@ -120,3 +200,476 @@ ArrowErrorCode ArrowBufferAppend(struct ArrowBuffer* buffer, const void* data,
   ArrowBufferAppendUnsafe(buffer, data, size_bytes);
   return NANOARROW_OK;
 }
+
+ArrowErrorCode ArrowBufferAppendZeros(struct ArrowBuffer* buffer, int64_t size_bytes) {
+  if (size_bytes <= 0) {
+    return NANOARROW_OK;
+  }
+
+  // Memory from allocate_zeroed() does not need to be written to
+  if (buffer->data == NULL && buffer->allocator.allocate_zeroed != NULL) {
+    int64_t capacity_bytes = ArrowBufferGrow(buffer, size_bytes);
+    uint8_t* data = buffer->allocator.allocate_zeroed(&buffer->allocator, capacity_bytes);
+    if (data == NULL) {
+      return ENOMEM;
+    }
+
+    buffer->data = data;
+    buffer->size_bytes = size_bytes;
+    buffer->capacity_bytes = capacity_bytes;
+    return NANOARROW_OK;
+  }
+
+  int result = ArrowBufferReserve(buffer, size_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  memset(buffer->data + buffer->size_bytes, 0, size_bytes);
+  buffer->size_bytes += size_bytes;
+  return NANOARROW_OK;
+}
+
+// Copies using stores that bypass the cache. Non-temporal stores are weakly
+// ordered, so they are fenced before returning to make the copy visible to
+// other threads like an ordinary write.
+static void ArrowMemcpyNonTemporal(uint8_t* dst, const uint8_t* src, int64_t size_bytes) {
+#if defined(__SSE2__)
+  // Copy up to the first cache line boundary with ordinary stores so that the
+  // streaming loop below writes whole, aligned cache lines
+  int64_t head_bytes = (int64_t)((64 - ((uintptr_t)dst & 63)) & 63);
+  if (head_bytes > size_bytes) {
+    head_bytes = size_bytes;
+  }
+
+  memcpy(dst, src, head_bytes);
+  dst += head_bytes;
+  src += head_bytes;
+  size_bytes -= head_bytes;
+
+  // Write one whole 64-byte cache line per iteration so that each
+  // write-combining buffer is flushed full
+  int64_t n_lines = size_bytes / 64;
+  for (int64_t i = 0; i < n_lines; i++) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(src + 0));
+    __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+    __m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+    _mm_stream_si128((__m128i*)(dst + 0), a);
+    _mm_stream_si128((__m128i*)(dst + 16), b);
+    _mm_stream_si128((__m128i*)(dst + 32), c);
+    _mm_stream_si128((__m128i*)(dst + 48), d);
+    dst += 64;
+    src += 64;
+  }
+
+  // The last partial line is still 16-byte aligned
+  size_bytes -= n_lines * 64;
+  while (size_bytes >= 16) {
+    _mm_stream_si128((__m128i*)dst, _mm_loadu_si128((const __m128i*)src));
+    dst += 16;
+    src += 16;
+    size_bytes -= 16;
+  }
+
+  memcpy(dst, src, size_bytes);
+  _mm_sfence();
+#else
+  memcpy(dst, src, size_bytes);
+#endif
+}
+
+void ArrowBufferAppendNonTemporalUnsafe(struct ArrowBuffer* buffer, const void* data,
+                                        int64_t size_bytes) {
+  if (size_bytes < NANOARROW_NON_TEMPORAL_THRESHOLD_BYTES) {
+    ArrowBufferAppendUnsafe(buffer, data, size_bytes);
+    return;
+  }
+
+  ArrowMemcpyNonTemporal(buffer->data + buffer->size_bytes, (const uint8_t*)data,
+                         size_bytes);
+  buffer->size_bytes += size_bytes;
+}
+
+ArrowErrorCode ArrowBufferAppendNonTemporal(struct ArrowBuffer* buffer, const void* data,
+                                            int64_t size_bytes) {
+  int result = ArrowBufferReserve(buffer, size_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  ArrowBufferAppendNonTemporalUnsafe(buffer, data, size_bytes);
+  return NANOARROW_OK;
+}
+
+static int ArrowStringBuilderHasLargeOffsets(struct ArrowStringBuilder* builder) {
+  return builder->type == NANOARROW_TYPE_LARGE_STRING ||
+         builder->type == NANOARROW_TYPE_LARGE_BINARY;
+}
+
+ArrowErrorCode ArrowStringBuilderInit(struct ArrowStringBuilder* builder,
+                                      enum ArrowType type, char promote_offsets) {
+  switch (type) {
+    case NANOARROW_TYPE_STRING:
+    case NANOARROW_TYPE_BINARY:
+    case NANOARROW_TYPE_LARGE_STRING:
+    case NANOARROW_TYPE_LARGE_BINARY:
+      break;
+    default:
+      return EINVAL;
+  }
+
+  ArrowBufferInit(&builder->offsets);
+  ArrowBufferInit(&builder->data);
+  builder->length = 0;
+  builder->type = type;
+  builder->promote_offsets = promote_offsets;
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowStringBuilderReserve(struct ArrowStringBuilder* builder,
+                                         int64_t additional_length,
+                                         int64_t additional_size_bytes) {
+  int64_t offset_size = ArrowStringBuilderHasLargeOffsets(builder) ? sizeof(int64_t)
+                                                                    : sizeof(int32_t);
+  int first_offset = builder->offsets.size_bytes == 0;
+
+  int result = ArrowBufferReserve(&builder->offsets,
+                                  (additional_length + first_offset) * offset_size);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  result = ArrowBufferReserve(&builder->data, additional_size_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  if (first_offset && offset_size == sizeof(int64_t)) {
+    ArrowBufferAppendInt64Unsafe(&builder->offsets, 0);
+  } else if (first_offset) {
+    ArrowBufferAppendInt32Unsafe(&builder->offsets, 0);
+  }
+
+  return NANOARROW_OK;
+}
+
+// Converts 32-bit offsets to 64-bit offsets with room for additional_length
+// more (or fails with EOVERFLOW if the builder does not promote its offsets).
+// The builder is unchanged on failure.
+static ArrowErrorCode ArrowStringBuilderPromoteOffsets(struct ArrowStringBuilder* builder,
+                                                       int64_t additional_length) {
+  if (!builder->promote_offsets) {
+    return EOVERFLOW;
+  }
+
+  struct ArrowBuffer offsets;
+  ArrowBufferInit(&offsets);
+  offsets.allocator = builder->offsets.allocator;
+  offsets.growth_policy = builder->offsets.growth_policy;
+
+  int64_t n_offsets = builder->offsets.size_bytes / sizeof(int32_t);
+  int64_t first_offset = n_offsets == 0;
+  int result = ArrowBufferReserve(
+      &offsets, (n_offsets + first_offset + additional_length) * sizeof(int64_t));
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  const int32_t* offsets32 = (const int32_t*)builder->offsets.data;
+  for (int64_t i = 0; i < n_offsets; i++) {
+    ArrowBufferAppendInt64Unsafe(&offsets, offsets32[i]);
+  }
+
+  ArrowBufferReset(&builder->offsets);
+  ArrowBufferMove(&offsets, &builder->offsets);
+
+  if (builder->type == NANOARROW_TYPE_STRING) {
+    builder->type = NANOARROW_TYPE_LARGE_STRING;
+  } else {
+    builder->type = NANOARROW_TYPE_LARGE_BINARY;
+  }
+
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowStringBuilderAppend(struct ArrowStringBuilder* builder,
+                                        struct ArrowStringView value) {
+  return ArrowStringBuilderAppendBulk(builder, &value, 1);
+}
+
+ArrowErrorCode ArrowStringBuilderAppendBulk(struct ArrowStringBuilder* builder,
+                                            const struct ArrowStringView* values,
+                                            int64_t n_values) {
+  if (n_values <= 0) {
+    return NANOARROW_OK;
+  }
+
+  int64_t size_bytes = 0;
+  for (int64_t i = 0; i < n_values; i++) {
+    if (values[i].n_bytes < 0) {
+      return EINVAL;
+    }
+
+    if (values[i].n_bytes > (INT64_MAX - size_bytes)) {
+      return EOVERFLOW;
+    }
+
+    size_bytes += values[i].n_bytes;
+  }
+
+  int promote = !ArrowStringBuilderHasLargeOffsets(builder) &&
+                size_bytes > (INT32_MAX - builder->data.size_bytes);
+  if (promote && !builder->promote_offsets) {
+    return EOVERFLOW;
+  }
+
+  // Everything that can fail happens before the offsets are promoted so that
+  // the builder is unchanged on error: the data is reserved first and the
+  // promoted offsets are allocated with room for the new values, after which
+  // reserving the offsets cannot fail.
+  int result = ArrowBufferReserve(&builder->data, size_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  if (promote) {
+    result = ArrowStringBuilderPromoteOffsets(builder, n_values);
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  result = ArrowStringBuilderReserve(builder, n_values, 0);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  // The offsets are the prefix sum of the value sizes starting at the current
+  // size of the data buffer
+  int64_t offset = builder->data.size_bytes;
+  if (ArrowStringBuilderHasLargeOffsets(builder)) {
+    for (int64_t i = 0; i < n_values; i++) {
+      ArrowBufferAppendUnsafe(&builder->data, values[i].data, values[i].n_bytes);
+      offset += values[i].n_bytes;
+      ArrowBufferAppendInt64Unsafe(&builder->offsets, offset);
+    }
+  } else {
+    for (int64_t i = 0; i < n_values; i++) {
+      ArrowBufferAppendUnsafe(&builder->data, values[i].data, values[i].n_bytes);
+      offset += values[i].n_bytes;
+      ArrowBufferAppendInt32Unsafe(&builder->offsets, (int32_t)offset);
+    }
+  }
+
+  builder->length += n_values;
+  return NANOARROW_OK;
+}
+
+void ArrowStringBuilderReset(struct ArrowStringBuilder* builder) {
+  ArrowBufferReset(&builder->offsets);
+  ArrowBufferReset(&builder->data);
+  builder->length = 0;
+}
+
+struct ArrowSharedBuffer {
+  struct ArrowBuffer buffer;
+  int64_t reference_count;
+};
+
+ArrowErrorCode ArrowSharedBufferInit(struct ArrowSharedBuffer** shared_buffer_out,
+                                     struct ArrowBuffer* buffer) {
+  struct ArrowSharedBuffer* shared_buffer =
+      (struct ArrowSharedBuffer*)ArrowMalloc(sizeof(struct ArrowSharedBuffer));
+  if (shared_buffer == NULL) {
+    return ENOMEM;
+  }
+
+  ArrowBufferMove(buffer, &shared_buffer->buffer);
+  shared_buffer->reference_count = 1;
+  *shared_buffer_out = shared_buffer;
+  return NANOARROW_OK;
+}
+
+const uint8_t* ArrowSharedBufferData(struct ArrowSharedBuffer* shared_buffer) {
+  return shared_buffer->buffer.data;
+}
+
+int64_t ArrowSharedBufferSizeBytes(struct ArrowSharedBuffer* shared_buffer) {
+  return shared_buffer->buffer.size_bytes;
+}
+
+static void ArrowSharedBufferFreeSlice(struct ArrowBufferAllocator* allocator,
+                                       uint8_t* ptr, int64_t size) {
+  ArrowSharedBufferRelease((struct ArrowSharedBuffer*)allocator->private_data);
+}
+
+ArrowErrorCode ArrowSharedBufferSlice(struct ArrowSharedBuffer* shared_buffer,
+                                      int64_t offset, int64_t size_bytes,
+                                      struct ArrowBuffer* buffer_out) {
+  if (offset < 0 || size_bytes < 0 ||
+      size_bytes > (shared_buffer->buffer.size_bytes - offset)) {
+    return EINVAL;
+  }
+
+  // A slice of nothing doesn't need a reference (and would never release it
+  // because ArrowBufferReset() only frees non-NULL data)
+  if (shared_buffer->buffer.data == NULL) {
+    ArrowBufferInit(buffer_out);
+    return NANOARROW_OK;
+  }
+
+  ArrowAtomicAdd(&shared_buffer->reference_count, 1);
+
+  struct ArrowBufferAllocator deallocator =
+      ArrowBufferDeallocator(&ArrowSharedBufferFreeSlice, shared_buffer);
+  ArrowBufferInitWrap(buffer_out, shared_buffer->buffer.data + offset, size_bytes,
+                      &deallocator);
+  return NANOARROW_OK;
+}
+
+void ArrowSharedBufferRelease(struct ArrowSharedBuffer* shared_buffer) {
+  if (ArrowAtomicAdd(&shared_buffer->reference_count, -1) == 0) {
+    ArrowBufferReset(&shared_buffer->buffer);
+    ArrowFree(shared_buffer);
+  }
+}
+
+ArrowErrorCode ArrowBufferConcatenate(struct ArrowBuffer* buffer,
+                                      const struct ArrowBufferView* views,
+                                      int64_t n_views) {
+  int64_t size_bytes = 0;
+  for (int64_t i = 0; i < n_views; i++) {
+    if (views[i].size_bytes < 0 || views[i].size_bytes > (INT64_MAX - size_bytes)) {
+      return EINVAL;
+    }
+
+    size_bytes += views[i].size_bytes;
+  }
+
+  int result = ArrowBufferReserve(buffer, size_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  for (int64_t i = 0; i < n_views; i++) {
+    ArrowBufferAppendUnsafe(buffer, views[i].data, views[i].size_bytes);
+  }
+
+  return NANOARROW_OK;
+}
+
+static int64_t ArrowBufferViewGetOffset(const struct ArrowBufferView* view,
+                                        int64_t offset_size, int64_t i) {
+  if (offset_size == sizeof(int32_t)) {
+    return ((const int32_t*)view->data)[i];
+  } else {
+    return ((const int64_t*)view->data)[i];
+  }
+}
+
+static ArrowErrorCode ArrowBufferConcatenateOffsets(struct ArrowBuffer* buffer,
+                                                    const struct ArrowBufferView* views,
+                                                    int64_t n_views, int64_t offset_size,
+                                                    int64_t max_offset) {
+  // Offsets continue from the last offset already in the buffer
+  int64_t n_existing = buffer->size_bytes / offset_size;
+  int64_t base = 0;
+  if (n_existing > 0) {
+    struct ArrowBufferView existing = {buffer->data, buffer->size_bytes};
+    base = ArrowBufferViewGetOffset(&existing, offset_size, n_existing - 1);
+  }
+
+  // Check every view and count the offsets before anything is written
+  int64_t n_offsets = n_existing == 0;
+  int64_t end = base;
+  for (int64_t i = 0; i < n_views; i++) {
+    int64_t n = views[i].size_bytes / offset_size;
+    if (n == 0) {
+      continue;
+    }
+
+    int64_t first = ArrowBufferViewGetOffset(views + i, offset_size, 0);
+    int64_t last = ArrowBufferViewGetOffset(views + i, offset_size, n - 1);
+    if (first < 0 || last < first) {
+      return EINVAL;
+    }
+
+    if ((last - first) > (max_offset - end)) {
+      return EOVERFLOW;
+    }
+
+    end += last - first;
+    n_offsets += n - 1;
+  }
+
+  int result = ArrowBufferReserve(buffer, n_offsets * offset_size);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  int64_t size_bytes_before = buffer->size_bytes;
+  if (n_existing == 0 && offset_size == sizeof(int32_t)) {
+    ArrowBufferAppendInt32Unsafe(buffer, 0);
+  } else if (n_existing == 0) {
+    ArrowBufferAppendInt64Unsafe(buffer, 0);
+  }
+
+  // Each view's first offset is shared with the previous view's last offset.
+  // Only the first and last offsets were checked above, so the offsets in
+  // between are checked as they are copied, before they are rebased: offsets
+  // that lie between the first and the last can be rebased without overflow
+  // because the rebased last offset is known to fit.
+  for (int64_t i = 0; i < n_views; i++) {
+    int64_t n = views[i].size_bytes / offset_size;
+    if (n == 0) {
+      continue;
+    }
+
+    if (offset_size == sizeof(int32_t)) {
+      const int32_t* offsets = (const int32_t*)views[i].data;
+      int32_t last = offsets[n - 1];
+      int32_t shift = (int32_t)(base - offsets[0]);
+      for (int64_t j = 1; j < n; j++) {
+        if (offsets[j] < offsets[j - 1] || offsets[j] > last) {
+          buffer->size_bytes = size_bytes_before;
+          return EINVAL;
+        }
+
+        ArrowBufferAppendInt32Unsafe(buffer, offsets[j] + shift);
+      }
+
+      base += last - offsets[0];
+    } else {
+      const int64_t* offsets = (const int64_t*)views[i].data;
+      int64_t last = offsets[n - 1];
+      int64_t shift = base - offsets[0];
+      for (int64_t j = 1; j < n; j++) {
+        if (offsets[j] < offsets[j - 1] || offsets[j] > last) {
+          buffer->size_bytes = size_bytes_before;
+          return EINVAL;
+        }
+
+        ArrowBufferAppendInt64Unsafe(buffer, offsets[j] + shift);
+      }
+
+      base += last - offsets[0];
+    }
+  }
+
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowBufferConcatenateInt32Offsets(struct ArrowBuffer* buffer,
+                                                  const struct ArrowBufferView* views,
+                                                  int64_t n_views) {
+  return ArrowBufferConcatenateOffsets(buffer, views, n_views, sizeof(int32_t),
+                                       INT32_MAX);
+}
+
+ArrowErrorCode ArrowBufferConcatenateInt64Offsets(struct ArrowBuffer* buffer,
+                                                  const struct ArrowBufferView* views,
+                                                  int64_t n_views) {
+  return ArrowBufferConcatenateOffsets(buffer, views, n_views, sizeof(int64_t),
+                                       INT64_MAX);
+}
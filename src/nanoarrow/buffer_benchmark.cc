@@ -0,0 +1,122 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+typedef ArrowErrorCode (*AppendFunc)(struct ArrowBuffer*, const void*, int64_t);
+
+// A page copied from disk: much larger than the L2 cache
+static const int64_t kPageBytes = 32 * 1024 * 1024;
+
+static int64_t SumHot(const std::vector<int64_t>& hot) {
+  return std::accumulate(hot.begin(), hot.end(), int64_t{0});
+}
+
+// Appends a page and then scans a hot working set of state.range(0) bytes, as
+// a query that copies pages between operations on its own data would. The
+// hot_scan_us counter is the time taken by the scan, which goes up when the
+// append evicted the working set from the cache.
+static void BM_AppendPageThenScan(benchmark::State& state, AppendFunc append) {
+  std::vector<uint8_t> page(kPageBytes, 1);
+  std::vector<int64_t> hot(state.range(0) / sizeof(int64_t), 1);
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  if (ArrowBufferReserve(&buffer, kPageBytes) != NANOARROW_OK) {
+    state.SkipWithError("reserve failed");
+  }
+
+  std::chrono::duration<double> scan_time(0);
+  for (auto _ : state) {
+    buffer.size_bytes = 0;
+    append(&buffer, page.data(), kPageBytes);
+
+    auto start = std::chrono::steady_clock::now();
+    benchmark::DoNotOptimize(SumHot(hot));
+    scan_time += std::chrono::steady_clock::now() - start;
+  }
+
+  state.SetBytesProcessed(state.iterations() * kPageBytes);
+  state.counters["hot_scan_us"] =
+      benchmark::Counter(scan_time.count() * 1e6, benchmark::Counter::kAvgIterations);
+  ArrowBufferReset(&buffer);
+}
+
+// Appends pages while another thread repeatedly scans a hot working set of
+// state.range(0) bytes. The hot_scans_per_s counter is the other thread's
+// throughput, which goes down when the appends evict its data from the caches
+// the two threads share.
+static void BM_AppendPageConcurrentScan(benchmark::State& state, AppendFunc append) {
+  if (std::thread::hardware_concurrency() < 2) {
+    state.SkipWithError("requires at least two CPUs");
+    return;
+  }
+
+  std::vector<uint8_t> page(kPageBytes, 1);
+  std::vector<int64_t> hot(state.range(0) / sizeof(int64_t), 1);
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  if (ArrowBufferReserve(&buffer, kPageBytes) != NANOARROW_OK) {
+    state.SkipWithError("reserve failed");
+  }
+
+  std::atomic<bool> done(false);
+  std::atomic<int64_t> n_scans(0);
+  std::thread scanner([&] {
+    while (!done.load(std::memory_order_relaxed)) {
+      benchmark::DoNotOptimize(SumHot(hot));
+      n_scans.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    buffer.size_bytes = 0;
+    append(&buffer, page.data(), kPageBytes);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  done = true;
+  scanner.join();
+
+  state.SetBytesProcessed(state.iterations() * kPageBytes);
+  state.counters["hot_scans_per_s"] = n_scans / elapsed.count();
+  ArrowBufferReset(&buffer);
+}
+
+BENCHMARK_CAPTURE(BM_AppendPageThenScan, memcpy, &ArrowBufferAppend)
+    ->Arg(256 * 1024)
+    ->Arg(1024 * 1024);
+BENCHMARK_CAPTURE(BM_AppendPageThenScan, non_temporal, &ArrowBufferAppendNonTemporal)
+    ->Arg(256 * 1024)
+    ->Arg(1024 * 1024);
+BENCHMARK_CAPTURE(BM_AppendPageConcurrentScan, memcpy, &ArrowBufferAppend)
+    ->Arg(1024 * 1024)
+    ->Arg(8 * 1024 * 1024)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_AppendPageConcurrentScan, non_temporal,
+                  &ArrowBufferAppendNonTemporal)
+    ->Arg(1024 * 1024)
+    ->Arg(8 * 1024 * 1024)
+    ->UseRealTime();
@@ -15,9 +15,13 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
+#include <limits>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -160,3 +164,626 @@ TEST(BufferTest, BufferTestError) {
 
   ArrowBufferReset(&buffer);
 }
+
+TEST(BufferTest, BufferTestErrorKeepsData) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorLimitInit(&allocator, ArrowBufferAllocatorDefault(), 16,
+                                          16, nullptr, nullptr),
+            NANOARROW_OK);
+
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &allocator), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppend(&buffer, "abcd", 4), NANOARROW_OK);
+
+  // A failed reallocation leaves the buffer as it was
+  uint8_t* data = buffer.data;
+  EXPECT_EQ(ArrowBufferReserve(&buffer, 100), ENOMEM);
+  EXPECT_EQ(buffer.data, data);
+  EXPECT_EQ(buffer.size_bytes, 4);
+  EXPECT_EQ(buffer.capacity_bytes, 4);
+  EXPECT_EQ(memcmp(buffer.data, "abcd", 4), 0);
+
+  ArrowBufferReset(&buffer);
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&allocator), 0);
+  ArrowBufferAllocatorLimitRelease(&allocator);
+}
+
+struct ForeignMemory {
+  std::vector<int32_t> values;
+  int n_frees;
+  uint8_t* freed_ptr;
+};
+
+static void ForeignMemoryFree(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                              int64_t size) {
+  auto foreign = reinterpret_cast<ForeignMemory*>(allocator->private_data);
+  foreign->n_frees++;
+  foreign->freed_ptr = ptr;
+}
+
+TEST(BufferTest, BufferTestAppendZeros) {
+  struct ArrowBuffer buffer;
+
+  // An empty buffer gets its zeroes straight from the allocator
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferAppendZeros(&buffer, 1000), NANOARROW_OK);
+  EXPECT_EQ(buffer.size_bytes, 1000);
+  EXPECT_EQ(buffer.capacity_bytes, 1000);
+  EXPECT_EQ(std::count(buffer.data, buffer.data + 1000, 0), 1000);
+
+  // ...whereas a buffer with data has them written
+  uint8_t value = 0xff;
+  ASSERT_EQ(ArrowBufferAppend(&buffer, &value, 1), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppendZeros(&buffer, 10), NANOARROW_OK);
+  EXPECT_EQ(buffer.size_bytes, 1011);
+  EXPECT_EQ(buffer.data[1000], 0xff);
+  EXPECT_EQ(std::count(buffer.data + 1001, buffer.data + 1011, 0), 10);
+
+  ASSERT_EQ(ArrowBufferAppendZeros(&buffer, 0), NANOARROW_OK);
+  EXPECT_EQ(buffer.size_bytes, 1011);
+  ArrowBufferReset(&buffer);
+
+  // Allocators without allocate_zeroed() still give zeroes
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &test_allocator), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppendZeros(&buffer, 100), NANOARROW_OK);
+  EXPECT_EQ(buffer.size_bytes, 100);
+  EXPECT_EQ(std::count(buffer.data, buffer.data + 100, 0), 100);
+  ArrowBufferReset(&buffer);
+
+  ArrowBufferInit(&buffer);
+  EXPECT_EQ(ArrowBufferAppendZeros(&buffer, std::numeric_limits<int64_t>::max()),
+            ENOMEM);
+  EXPECT_EQ(buffer.data, nullptr);
+  EXPECT_EQ(buffer.size_bytes, 0);
+}
+
+TEST(BufferTest, BufferTestAppendNonTemporal) {
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+
+  // Large enough to take the non-temporal path, with a size that is not a
+  // multiple of the cache line size
+  std::vector<uint8_t> data(3 * 1024 * 1024 + 13);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i % 251);
+  }
+
+  // Small appends are ordinary copies
+  ASSERT_EQ(ArrowBufferAppendNonTemporal(&buffer, data.data(), 3), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppendNonTemporal(&buffer, data.data(), 0), NANOARROW_OK);
+  EXPECT_EQ(buffer.size_bytes, 3);
+
+  // ...and large ones start at an unaligned address
+  ASSERT_EQ(ArrowBufferAppendNonTemporal(&buffer, data.data(), data.size()),
+            NANOARROW_OK);
+  EXPECT_EQ(buffer.size_bytes, static_cast<int64_t>(3 + data.size()));
+  EXPECT_EQ(memcmp(buffer.data, data.data(), 3), 0);
+  EXPECT_EQ(memcmp(buffer.data + 3, data.data(), data.size()), 0);
+
+  ASSERT_EQ(ArrowBufferReserve(&buffer, data.size() - 1), NANOARROW_OK);
+  ArrowBufferAppendNonTemporalUnsafe(&buffer, data.data() + 1, data.size() - 1);
+  EXPECT_EQ(buffer.size_bytes, static_cast<int64_t>(2 + 2 * data.size()));
+  EXPECT_EQ(memcmp(buffer.data + 3 + data.size(), data.data() + 1, data.size() - 1),
+            0);
+
+  ArrowBufferReset(&buffer);
+}
+
+TEST(BufferTest, BufferTestAppendHelpers) {
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendInt8(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<int8_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendUInt8(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<uint8_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendInt16(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<int16_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendUInt16(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<uint16_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendInt32(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<int32_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendUInt32(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<uint32_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendInt64(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<int64_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendUInt64(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<uint64_t*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendFloat(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<float*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  EXPECT_EQ(ArrowBufferAppendDouble(&buffer, 123), NANOARROW_OK);
+  EXPECT_EQ(reinterpret_cast<double*>(buffer.data)[0], 123);
+  ArrowBufferReset(&buffer);
+
+  // Appending many values grows the buffer as needed
+  for (int32_t i = 0; i < 1000; i++) {
+    ASSERT_EQ(ArrowBufferAppendInt32(&buffer, i), NANOARROW_OK);
+  }
+  EXPECT_EQ(buffer.size_bytes, 1000 * sizeof(int32_t));
+  EXPECT_EQ(reinterpret_cast<int32_t*>(buffer.data)[999], 999);
+  ArrowBufferReset(&buffer);
+
+  // ...or after a single reservation without checking the capacity
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 1 + 2 * sizeof(int64_t) + sizeof(double)),
+            NANOARROW_OK);
+  int64_t capacity = buffer.capacity_bytes;
+  ArrowBufferAppendUInt8Unsafe(&buffer, 1);
+  ArrowBufferAppendInt64Unsafe(&buffer, -2);
+  ArrowBufferAppendUInt64Unsafe(&buffer, 3);
+  ArrowBufferAppendDoubleUnsafe(&buffer, 4.5);
+  EXPECT_EQ(buffer.capacity_bytes, capacity);
+  EXPECT_EQ(buffer.size_bytes, 1 + 2 * sizeof(int64_t) + sizeof(double));
+
+  // Values are written unaligned
+  int64_t int64_value;
+  memcpy(&int64_value, buffer.data + 1, sizeof(int64_t));
+  EXPECT_EQ(int64_value, -2);
+  double double_value;
+  memcpy(&double_value, buffer.data + 1 + 2 * sizeof(int64_t), sizeof(double));
+  EXPECT_EQ(double_value, 4.5);
+
+  ArrowBufferReset(&buffer);
+}
+
+TEST(BufferTest, BufferTestGrowthPolicy) {
+  struct ArrowBufferGrowthPolicy policy;
+  ArrowBufferGrowthPolicyInit(&policy);
+  EXPECT_EQ(policy.growth_factor, 2);
+
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  EXPECT_EQ(buffer.growth_policy, nullptr);
+
+  // The default policy behaves like no policy at all
+  ASSERT_EQ(ArrowBufferSetGrowthPolicy(&buffer, &policy), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 10), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 10);
+  buffer.size_bytes = 10;
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 1), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 20);
+  ArrowBufferReset(&buffer);
+
+  // A factor of 1.5 with a minimum first allocation
+  policy.growth_factor = 1.5;
+  policy.min_capacity_bytes = 64;
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 1), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 64);
+  buffer.size_bytes = 64;
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 1), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 96);
+
+  // ...but never less than what was asked for
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 1000), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 1064);
+  ArrowBufferReset(&buffer);
+
+  // Rounding to a page boundary
+  policy.alignment_bytes = 4096;
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 1), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 4096);
+  buffer.size_bytes = 4096;
+  ASSERT_EQ(ArrowBufferReserve(&buffer, 1), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 8192);
+  ArrowBufferReset(&buffer);
+
+  // Growing linearly above a threshold
+  policy.growth_factor = 2;
+  policy.alignment_bytes = 0;
+  policy.linear_threshold_bytes = 256;
+  policy.linear_increment_bytes = 100;
+  std::vector<int64_t> capacities;
+  for (int i = 0; i < 600; i++) {
+    ASSERT_EQ(ArrowBufferAppendUInt8(&buffer, 0), NANOARROW_OK);
+    if (capacities.empty() || capacities.back() != buffer.capacity_bytes) {
+      capacities.push_back(buffer.capacity_bytes);
+    }
+  }
+  EXPECT_EQ(capacities, std::vector<int64_t>({64, 128, 256, 356, 456, 556, 656}));
+  ArrowBufferReset(&buffer);
+
+  // Appending zeroes to an empty buffer also follows the policy
+  ASSERT_EQ(ArrowBufferAppendZeros(&buffer, 10), NANOARROW_OK);
+  EXPECT_EQ(buffer.capacity_bytes, 64);
+  EXPECT_EQ(std::count(buffer.data, buffer.data + 64, 0), 64);
+  ArrowBufferReset(&buffer);
+
+  ASSERT_EQ(ArrowBufferSetGrowthPolicy(&buffer, nullptr), NANOARROW_OK);
+  EXPECT_EQ(buffer.growth_policy, nullptr);
+
+  // Invalid policies
+  ArrowBufferGrowthPolicyInit(&policy);
+  policy.growth_factor = 0.5;
+  EXPECT_EQ(ArrowBufferSetGrowthPolicy(&buffer, &policy), EINVAL);
+  policy.growth_factor = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(ArrowBufferSetGrowthPolicy(&buffer, &policy), EINVAL);
+  policy.growth_factor = 2;
+  policy.linear_threshold_bytes = 100;
+  EXPECT_EQ(ArrowBufferSetGrowthPolicy(&buffer, &policy), EINVAL);
+  policy.linear_threshold_bytes = 0;
+  policy.min_capacity_bytes = -1;
+  EXPECT_EQ(ArrowBufferSetGrowthPolicy(&buffer, &policy), EINVAL);
+  EXPECT_EQ(buffer.growth_policy, nullptr);
+}
+
+TEST(BufferTest, BufferTestStringBuilder) {
+  struct ArrowStringBuilder builder;
+  EXPECT_EQ(ArrowStringBuilderInit(&builder, NANOARROW_TYPE_INT32, 0), EINVAL);
+
+  ASSERT_EQ(ArrowStringBuilderInit(&builder, NANOARROW_TYPE_STRING, 0), NANOARROW_OK);
+  EXPECT_EQ(builder.offsets.data, nullptr);
+  EXPECT_EQ(builder.data.data, nullptr);
+
+  // Finishing an empty builder still gives one offset
+  ASSERT_EQ(ArrowStringBuilderReserve(&builder, 0, 0), NANOARROW_OK);
+  EXPECT_EQ(builder.length, 0);
+  ASSERT_EQ(builder.offsets.size_bytes, sizeof(int32_t));
+  EXPECT_EQ(reinterpret_cast<int32_t*>(builder.offsets.data)[0], 0);
+
+  ASSERT_EQ(ArrowStringBuilderAppend(&builder, {"abc", 3}), NANOARROW_OK);
+  ASSERT_EQ(ArrowStringBuilderAppend(&builder, {nullptr, 0}), NANOARROW_OK);
+
+  std::vector<struct ArrowStringView> values = {{"de", 2}, {"fghi", 4}, {"j", 1}};
+  ASSERT_EQ(ArrowStringBuilderAppendBulk(&builder, values.data(), values.size()),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowStringBuilderAppendBulk(&builder, nullptr, 0), NANOARROW_OK);
+
+  EXPECT_EQ(builder.length, 5);
+  EXPECT_EQ(builder.type, NANOARROW_TYPE_STRING);
+  const int32_t* offsets = reinterpret_cast<const int32_t*>(builder.offsets.data);
+  EXPECT_EQ(std::vector<int32_t>(offsets, offsets + 6),
+            std::vector<int32_t>({0, 3, 3, 5, 9, 10}));
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(builder.data.data),
+                        builder.data.size_bytes),
+            "abcdefghij");
+  ArrowStringBuilderReset(&builder);
+  EXPECT_EQ(builder.length, 0);
+  EXPECT_EQ(builder.offsets.data, nullptr);
+
+  // Large types use 64-bit offsets from the start
+  ASSERT_EQ(ArrowStringBuilderInit(&builder, NANOARROW_TYPE_LARGE_BINARY, 0),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowStringBuilderAppendBulk(&builder, values.data(), values.size()),
+            NANOARROW_OK);
+  const int64_t* large_offsets = reinterpret_cast<const int64_t*>(builder.offsets.data);
+  EXPECT_EQ(std::vector<int64_t>(large_offsets, large_offsets + 4),
+            std::vector<int64_t>({0, 2, 6, 7}));
+  ArrowStringBuilderReset(&builder);
+}
+
+TEST(BufferTest, BufferTestStringBuilderOverflow) {
+  // Use a data buffer that can't actually grow to 2 GB
+  struct ArrowBufferAllocator limit;
+  ASSERT_EQ(ArrowBufferAllocatorLimitInit(&limit, ArrowBufferAllocatorDefault(), 1024,
+                                          1024, nullptr, nullptr),
+            NANOARROW_OK);
+  struct ArrowStringView huge = {"", std::numeric_limits<int32_t>::max()};
+
+  // Without promotion the builder refuses the value and is left as it was
+  struct ArrowStringBuilder builder;
+  ASSERT_EQ(ArrowStringBuilderInit(&builder, NANOARROW_TYPE_STRING, 0), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferSetAllocator(&builder.data, &limit), NANOARROW_OK);
+  ASSERT_EQ(ArrowStringBuilderAppend(&builder, {"abc", 3}), NANOARROW_OK);
+  EXPECT_EQ(ArrowStringBuilderAppend(&builder, huge), EOVERFLOW);
+
+  std::vector<struct ArrowStringView> values = {{"de", 2}, huge};
+  EXPECT_EQ(ArrowStringBuilderAppendBulk(&builder, values.data(), values.size()),
+            EOVERFLOW);
+  EXPECT_EQ(builder.length, 1);
+  EXPECT_EQ(builder.type, NANOARROW_TYPE_STRING);
+  EXPECT_EQ(builder.offsets.size_bytes, 2 * sizeof(int32_t));
+  EXPECT_EQ(builder.data.size_bytes, 3);
+
+  // Negative sizes are rejected before anything is reserved
+  values = {{"de", 2}, {"", -1}};
+  EXPECT_EQ(ArrowStringBuilderAppendBulk(&builder, values.data(), values.size()),
+            EINVAL);
+  EXPECT_EQ(builder.length, 1);
+  EXPECT_EQ(builder.offsets.size_bytes, 2 * sizeof(int32_t));
+  EXPECT_EQ(builder.data.size_bytes, 3);
+  ArrowStringBuilderReset(&builder);
+
+  // With promotion the offsets are only promoted once the data fits, so a
+  // builder that runs out of memory keeps its 32-bit offsets
+  ASSERT_EQ(ArrowStringBuilderInit(&builder, NANOARROW_TYPE_STRING, 1), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferSetAllocator(&builder.data, &limit), NANOARROW_OK);
+  ASSERT_EQ(ArrowStringBuilderAppend(&builder, {"abc", 3}), NANOARROW_OK);
+  ASSERT_EQ(ArrowStringBuilderAppend(&builder, {"de", 2}), NANOARROW_OK);
+  EXPECT_EQ(ArrowStringBuilderAppend(&builder, huge), ENOMEM);
+  EXPECT_EQ(builder.type, NANOARROW_TYPE_STRING);
+  EXPECT_EQ(builder.offsets.size_bytes, 3 * sizeof(int32_t));
+
+  ASSERT_EQ(ArrowStringBuilderAppend(&builder, {"f", 1}), NANOARROW_OK);
+  EXPECT_EQ(builder.length, 3);
+  const int32_t* offsets = reinterpret_cast<const int32_t*>(builder.offsets.data);
+  EXPECT_EQ(std::vector<int32_t>(offsets, offsets + 4),
+            std::vector<int32_t>({0, 3, 5, 6}));
+  ArrowStringBuilderReset(&builder);
+
+  // ...as does a binary builder that has not allocated anything yet
+  ASSERT_EQ(ArrowStringBuilderInit(&builder, NANOARROW_TYPE_BINARY, 1), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferSetAllocator(&builder.data, &limit), NANOARROW_OK);
+  huge.n_bytes++;
+  EXPECT_EQ(ArrowStringBuilderAppend(&builder, huge), ENOMEM);
+  EXPECT_EQ(builder.type, NANOARROW_TYPE_BINARY);
+  EXPECT_EQ(builder.offsets.size_bytes, 0);
+  ArrowStringBuilderReset(&builder);
+
+  EXPECT_EQ(ArrowBufferAllocatorLimitBytesAllocated(&limit), 0);
+  ArrowBufferAllocatorLimitRelease(&limit);
+}
+
+TEST(BufferTest, BufferTestWrap) {
+  ForeignMemory foreign = {{1, 2, 3}, 0, nullptr};
+  uint8_t* data = reinterpret_cast<uint8_t*>(foreign.values.data());
+
+  struct ArrowBufferAllocator deallocator =
+      ArrowBufferDeallocator(&ForeignMemoryFree, &foreign);
+  EXPECT_EQ(deallocator.allocate(&deallocator, 10), nullptr);
+
+  struct ArrowBuffer buffer;
+  ArrowBufferInitWrap(&buffer, data, 3 * sizeof(int32_t), &deallocator);
+  EXPECT_EQ(buffer.data, data);
+  EXPECT_EQ(buffer.size_bytes, 12);
+  EXPECT_EQ(buffer.capacity_bytes, 12);
+
+  // Moving and resetting does not copy
+  struct ArrowBuffer buffer_out;
+  ArrowBufferMove(&buffer, &buffer_out);
+  EXPECT_EQ(buffer_out.data, data);
+  EXPECT_EQ(foreign.n_frees, 0);
+
+  ArrowBufferReset(&buffer_out);
+  EXPECT_EQ(foreign.n_frees, 1);
+  EXPECT_EQ(foreign.freed_ptr, data);
+}
+
+TEST(BufferTest, BufferTestWrapGrow) {
+  ForeignMemory foreign = {{1, 2, 3}, 0, nullptr};
+  uint8_t* data = reinterpret_cast<uint8_t*>(foreign.values.data());
+
+  struct ArrowBufferAllocator deallocator =
+      ArrowBufferDeallocator(&ForeignMemoryFree, &foreign);
+  struct ArrowBuffer buffer;
+  ArrowBufferInitWrap(&buffer, data, 3 * sizeof(int32_t), &deallocator);
+
+  // Growing copies out and releases the foreign memory exactly once
+  int32_t value = 4;
+  ASSERT_EQ(ArrowBufferAppend(&buffer, &value, sizeof(int32_t)), NANOARROW_OK);
+  EXPECT_NE(buffer.data, data);
+  EXPECT_EQ(foreign.n_frees, 1);
+  EXPECT_EQ(foreign.freed_ptr, data);
+  EXPECT_EQ(buffer.allocator.free, ArrowBufferAllocatorDefault()->free);
+
+  const int32_t* values = reinterpret_cast<const int32_t*>(buffer.data);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[3], 4);
+
+  ArrowBufferReset(&buffer);
+  EXPECT_EQ(foreign.n_frees, 1);
+
+  // Shrinking to nothing also releases the foreign memory
+  ArrowBufferInitWrap(&buffer, data, 3 * sizeof(int32_t), &deallocator);
+  ASSERT_EQ(ArrowBufferResize(&buffer, 0, true), NANOARROW_OK);
+  EXPECT_EQ(buffer.data, nullptr);
+  EXPECT_EQ(foreign.n_frees, 2);
+  ASSERT_EQ(ArrowBufferAppend(&buffer, &value, sizeof(int32_t)), NANOARROW_OK);
+  ArrowBufferReset(&buffer);
+  EXPECT_EQ(foreign.n_frees, 2);
+}
+
+TEST(BufferTest, BufferTestSharedBuffer) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&allocator, ArrowBufferAllocatorDefault()),
+            NANOARROW_OK);
+
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &allocator), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppend(&buffer, "abcdefg", 7), NANOARROW_OK);
+  const uint8_t* data = buffer.data;
+
+  struct ArrowSharedBuffer* shared;
+  ASSERT_EQ(ArrowSharedBufferInit(&shared, &buffer), NANOARROW_OK);
+  EXPECT_EQ(buffer.data, nullptr);
+  EXPECT_EQ(ArrowSharedBufferData(shared), data);
+  EXPECT_EQ(ArrowSharedBufferSizeBytes(shared), 7);
+
+  struct ArrowBuffer slice1;
+  struct ArrowBuffer slice2;
+  ASSERT_EQ(ArrowSharedBufferSlice(shared, 0, 7, &slice1), NANOARROW_OK);
+  ASSERT_EQ(ArrowSharedBufferSlice(shared, 2, 3, &slice2), NANOARROW_OK);
+  EXPECT_EQ(slice1.data, data);
+  EXPECT_EQ(slice2.data, data + 2);
+  EXPECT_EQ(slice2.size_bytes, 3);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(slice2.data), slice2.size_bytes), "cde");
+
+  EXPECT_EQ(ArrowSharedBufferSlice(shared, -1, 1, &buffer), EINVAL);
+  EXPECT_EQ(ArrowSharedBufferSlice(shared, 0, 8, &buffer), EINVAL);
+  EXPECT_EQ(ArrowSharedBufferSlice(shared, 7, 1, &buffer), EINVAL);
+
+  // The memory outlives the reference returned when the buffer was shared...
+  struct ArrowBufferAllocatorStats stats;
+  ArrowSharedBufferRelease(shared);
+  ArrowBufferReset(&slice1);
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.n_frees, 0);
+
+  // ...and growing a slice copies it out of the shared memory
+  ASSERT_EQ(ArrowBufferAppend(&slice2, "f", 1), NANOARROW_OK);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(slice2.data), slice2.size_bytes),
+            "cdef");
+
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.n_frees, 1);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+
+  ArrowBufferReset(&slice2);
+  ArrowBufferAllocatorStatsRelease(&allocator);
+
+  // Slices of an empty shared buffer
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowSharedBufferInit(&shared, &buffer), NANOARROW_OK);
+  ASSERT_EQ(ArrowSharedBufferSlice(shared, 0, 0, &slice1), NANOARROW_OK);
+  EXPECT_EQ(slice1.data, nullptr);
+  ArrowBufferReset(&slice1);
+  ArrowSharedBufferRelease(shared);
+}
+
+TEST(BufferTest, BufferTestSharedBufferThreads) {
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&allocator, ArrowBufferAllocatorDefault()),
+            NANOARROW_OK);
+
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+  ASSERT_EQ(ArrowBufferSetAllocator(&buffer, &allocator), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppendZeros(&buffer, 1024), NANOARROW_OK);
+
+  struct ArrowSharedBuffer* shared;
+  ASSERT_EQ(ArrowSharedBufferInit(&shared, &buffer), NANOARROW_OK);
+
+  // Slices created on one thread and released on others
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    std::vector<struct ArrowBuffer> slices(1000);
+    for (struct ArrowBuffer& slice : slices) {
+      ASSERT_EQ(ArrowSharedBufferSlice(shared, i, 1, &slice), NANOARROW_OK);
+    }
+
+    threads.emplace_back([slices]() mutable {
+      for (struct ArrowBuffer& slice : slices) {
+        ArrowBufferReset(&slice);
+      }
+    });
+  }
+
+  ArrowSharedBufferRelease(shared);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  struct ArrowBufferAllocatorStats stats;
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.n_frees, 1);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+  ArrowBufferAllocatorStatsRelease(&allocator);
+}
+
+TEST(BufferTest, BufferTestConcatenate) {
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+
+  std::vector<struct ArrowBufferView> views = {
+      {"abc", 3}, {nullptr, 0}, {"de", 2}, {"fghij", 5}};
+  ASSERT_EQ(ArrowBufferConcatenate(&buffer, views.data(), views.size()), NANOARROW_OK);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(buffer.data), buffer.size_bytes),
+            "abcdefghij");
+  EXPECT_EQ(buffer.capacity_bytes, 10);
+
+  ASSERT_EQ(ArrowBufferConcatenate(&buffer, views.data(), 1), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferConcatenate(&buffer, nullptr, 0), NANOARROW_OK);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(buffer.data), buffer.size_bytes),
+            "abcdefghijabc");
+
+  // Invalid sizes are rejected before anything is allocated
+  std::vector<struct ArrowBufferView> negative = {{"abc", 3}, {"de", -2}};
+  EXPECT_EQ(ArrowBufferConcatenate(&buffer, negative.data(), negative.size()), EINVAL);
+  std::vector<struct ArrowBufferView> too_big = {
+      {"abc", std::numeric_limits<int64_t>::max()}, {"de", 2}};
+  EXPECT_EQ(ArrowBufferConcatenate(&buffer, too_big.data(), too_big.size()), EINVAL);
+  EXPECT_EQ(buffer.size_bytes, 13);
+  ArrowBufferReset(&buffer);
+}
+
+TEST(BufferTest, BufferTestConcatenateOffsets) {
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+
+  // The second array is a slice whose offsets don't start at zero
+  std::vector<int32_t> offsets1 = {0, 3, 3, 5};
+  std::vector<int32_t> offsets2 = {10, 14, 20};
+  std::vector<struct ArrowBufferView> views = {
+      {offsets1.data(), 4 * sizeof(int32_t)},
+      {nullptr, 0},
+      {offsets2.data(), 3 * sizeof(int32_t)}};
+  ASSERT_EQ(ArrowBufferConcatenateInt32Offsets(&buffer, views.data(), views.size()),
+            NANOARROW_OK);
+  const int32_t* offsets = reinterpret_cast<const int32_t*>(buffer.data);
+  EXPECT_EQ(std::vector<int32_t>(offsets, offsets + buffer.size_bytes / sizeof(int32_t)),
+            std::vector<int32_t>({0, 3, 3, 5, 9, 15}));
+  EXPECT_EQ(buffer.capacity_bytes, buffer.size_bytes);
+
+  // Further offsets continue from the last one
+  ASSERT_EQ(ArrowBufferConcatenateInt32Offsets(&buffer, views.data(), 1), NANOARROW_OK);
+  offsets = reinterpret_cast<const int32_t*>(buffer.data);
+  EXPECT_EQ(std::vector<int32_t>(offsets, offsets + buffer.size_bytes / sizeof(int32_t)),
+            std::vector<int32_t>({0, 3, 3, 5, 9, 15, 18, 18, 20}));
+
+  // Failures leave the buffer alone
+  std::vector<int32_t> too_big = {0, std::numeric_limits<int32_t>::max() - 10};
+  struct ArrowBufferView too_big_view = {too_big.data(), 2 * sizeof(int32_t)};
+  EXPECT_EQ(ArrowBufferConcatenateInt32Offsets(&buffer, &too_big_view, 1), EOVERFLOW);
+  std::vector<int32_t> decreasing = {5, 4};
+  struct ArrowBufferView decreasing_view = {decreasing.data(), 2 * sizeof(int32_t)};
+  EXPECT_EQ(ArrowBufferConcatenateInt32Offsets(&buffer, &decreasing_view, 1), EINVAL);
+  std::vector<int32_t> not_monotonic = {0, std::numeric_limits<int32_t>::max(), 1};
+  struct ArrowBufferView not_monotonic_view = {not_monotonic.data(),
+                                               3 * sizeof(int32_t)};
+  EXPECT_EQ(ArrowBufferConcatenateInt32Offsets(&buffer, &not_monotonic_view, 1), EINVAL);
+  EXPECT_EQ(buffer.size_bytes, 9 * sizeof(int32_t));
+  offsets = reinterpret_cast<const int32_t*>(buffer.data);
+  EXPECT_EQ(std::vector<int32_t>(offsets, offsets + buffer.size_bytes / sizeof(int32_t)),
+            std::vector<int32_t>({0, 3, 3, 5, 9, 15, 18, 18, 20}));
+  ArrowBufferReset(&buffer);
+
+  // Nothing to concatenate still gives the first offset
+  ASSERT_EQ(ArrowBufferConcatenateInt32Offsets(&buffer, nullptr, 0), NANOARROW_OK);
+  EXPECT_EQ(buffer.size_bytes, sizeof(int32_t));
+  ArrowBufferReset(&buffer);
+
+  // 64-bit offsets can go past 2 GB
+  std::vector<int64_t> large_offsets1 = {0, 3000000000};
+  std::vector<int64_t> large_offsets2 = {1, 3000000001};
+  std::vector<struct ArrowBufferView> large_views = {
+      {large_offsets1.data(), 2 * sizeof(int64_t)},
+      {large_offsets2.data(), 2 * sizeof(int64_t)}};
+  ASSERT_EQ(ArrowBufferConcatenateInt64Offsets(&buffer, large_views.data(),
+                                               large_views.size()),
+            NANOARROW_OK);
+  const int64_t* offsets64 = reinterpret_cast<const int64_t*>(buffer.data);
+  EXPECT_EQ(std::vector<int64_t>(offsets64, offsets64 + 3),
+            std::vector<int64_t>({0, 3000000000, 6000000000}));
+  ArrowBufferReset(&buffer);
+
+  // ...but are still checked for offsets that decrease in the middle of a view
+  // (before they are rebased, which here would overflow)
+  ASSERT_EQ(ArrowBufferConcatenateInt64Offsets(&buffer, large_views.data(), 1),
+            NANOARROW_OK);
+  std::vector<int64_t> large_not_monotonic = {0, std::numeric_limits<int64_t>::max(), 1};
+  struct ArrowBufferView large_not_monotonic_view = {large_not_monotonic.data(),
+                                                     3 * sizeof(int64_t)};
+  EXPECT_EQ(ArrowBufferConcatenateInt64Offsets(&buffer, &large_not_monotonic_view, 1),
+            EINVAL);
+  EXPECT_EQ(buffer.size_bytes, 2 * sizeof(int64_t));
+  ArrowBufferReset(&buffer);
+}
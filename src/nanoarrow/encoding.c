@@ -0,0 +1,645 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <errno.h>
+#include <string.h>
+
+#include "nanoarrow.h"
+
+// Values are read and written in native byte order and sign-extended to 64
+// bits; everything in an encoded buffer is little-endian. The byte-at-a-time
+// little-endian helpers compile to plain loads and stores on little-endian
+// platforms.
+
+#define NANOARROW_FOR_BLOCK_SIZE 128
+
+static int ArrowEncodingValidValueSize(int64_t value_size) {
+  return value_size == 1 || value_size == 2 || value_size == 4 || value_size == 8;
+}
+
+static int64_t ArrowEncodingReadValue(const uint8_t* data, int64_t value_size) {
+  switch (value_size) {
+    case 1: {
+      int8_t value;
+      memcpy(&value, data, sizeof(int8_t));
+      return value;
+    }
+    case 2: {
+      int16_t value;
+      memcpy(&value, data, sizeof(int16_t));
+      return value;
+    }
+    case 4: {
+      int32_t value;
+      memcpy(&value, data, sizeof(int32_t));
+      return value;
+    }
+    default: {
+      int64_t value;
+      memcpy(&value, data, sizeof(int64_t));
+      return value;
+    }
+  }
+}
+
+// The bulk readers and writers switch on value_size once so that each loop
+// is over a single type and can be vectorized
+static void ArrowEncodingReadValues(const uint8_t* data, int64_t value_size,
+                                    int64_t* values_out, int64_t n_values) {
+  switch (value_size) {
+    case 1:
+      for (int64_t i = 0; i < n_values; i++) {
+        values_out[i] = ((const int8_t*)data)[i];
+      }
+      break;
+    case 2:
+      for (int64_t i = 0; i < n_values; i++) {
+        int16_t value;
+        memcpy(&value, data + i * sizeof(int16_t), sizeof(int16_t));
+        values_out[i] = value;
+      }
+      break;
+    case 4:
+      for (int64_t i = 0; i < n_values; i++) {
+        int32_t value;
+        memcpy(&value, data + i * sizeof(int32_t), sizeof(int32_t));
+        values_out[i] = value;
+      }
+      break;
+    default:
+      memcpy(values_out, data, n_values * sizeof(int64_t));
+      break;
+  }
+}
+
+static void ArrowEncodingWriteValues(uint8_t* data, int64_t value_size,
+                                     const int64_t* values, int64_t n_values) {
+  switch (value_size) {
+    case 1:
+      for (int64_t i = 0; i < n_values; i++) {
+        ((int8_t*)data)[i] = (int8_t)values[i];
+      }
+      break;
+    case 2:
+      for (int64_t i = 0; i < n_values; i++) {
+        int16_t value = (int16_t)values[i];
+        memcpy(data + i * sizeof(int16_t), &value, sizeof(int16_t));
+      }
+      break;
+    case 4:
+      for (int64_t i = 0; i < n_values; i++) {
+        int32_t value = (int32_t)values[i];
+        memcpy(data + i * sizeof(int32_t), &value, sizeof(int32_t));
+      }
+      break;
+    default:
+      memcpy(data, values, n_values * sizeof(int64_t));
+      break;
+  }
+}
+
+static void ArrowEncodingFillValues(uint8_t* data, int64_t value_size, int64_t value,
+                                    int64_t n_values) {
+  switch (value_size) {
+    case 1:
+      memset(data, (int8_t)value, n_values);
+      break;
+    case 2: {
+      int16_t narrow = (int16_t)value;
+      for (int64_t i = 0; i < n_values; i++) {
+        memcpy(data + i * sizeof(int16_t), &narrow, sizeof(int16_t));
+      }
+      break;
+    }
+    case 4: {
+      int32_t narrow = (int32_t)value;
+      for (int64_t i = 0; i < n_values; i++) {
+        memcpy(data + i * sizeof(int32_t), &narrow, sizeof(int32_t));
+      }
+      break;
+    }
+    default:
+      for (int64_t i = 0; i < n_values; i++) {
+        memcpy(data + i * sizeof(int64_t), &value, sizeof(int64_t));
+      }
+      break;
+  }
+}
+
+static uint64_t ArrowEncodingLoadLE(const uint8_t* data, int64_t n_bytes) {
+  uint64_t value = 0;
+  for (int64_t i = 0; i < n_bytes; i++) {
+    value |= (uint64_t)data[i] << (8 * i);
+  }
+
+  return value;
+}
+
+static void ArrowEncodingStoreLE(uint8_t* data, uint64_t value, int64_t n_bytes) {
+  for (int64_t i = 0; i < n_bytes; i++) {
+    data[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static ArrowErrorCode ArrowEncodingAppendLE(struct ArrowBuffer* out, uint64_t value,
+                                            int64_t n_bytes) {
+  int result = ArrowBufferReserve(out, n_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  ArrowEncodingStoreLE(out->data + out->size_bytes, value, n_bytes);
+  out->size_bytes += n_bytes;
+  return NANOARROW_OK;
+}
+
+// Reads n_bytes little-endian bytes from an encoded buffer, failing if there
+// aren't enough left
+static int ArrowEncodingConsumeLE(struct ArrowBufferView* encoded, int64_t n_bytes,
+                                  uint64_t* value_out) {
+  if (encoded->size_bytes < n_bytes) {
+    return EINVAL;
+  }
+
+  *value_out = ArrowEncodingLoadLE((const uint8_t*)encoded->data, n_bytes);
+  encoded->data = (const uint8_t*)encoded->data + n_bytes;
+  encoded->size_bytes -= n_bytes;
+  return NANOARROW_OK;
+}
+
+static ArrowErrorCode ArrowEncodingCheckValues(struct ArrowBufferView values,
+                                               int64_t value_size) {
+  if (!ArrowEncodingValidValueSize(value_size) || values.size_bytes < 0 ||
+      (values.size_bytes % value_size) != 0) {
+    return EINVAL;
+  }
+
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowBufferEncodeRunLength(struct ArrowBufferView values,
+                                          int64_t value_size, struct ArrowBuffer* out) {
+  int result = ArrowEncodingCheckValues(values, value_size);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  int64_t out_size_bytes = out->size_bytes;
+  const uint8_t* data = (const uint8_t*)values.data;
+  int64_t n_values = values.size_bytes / value_size;
+
+  result = ArrowEncodingAppendLE(out, n_values, sizeof(int64_t));
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  int64_t i = 0;
+  while (i < n_values) {
+    uint64_t value = (uint64_t)ArrowEncodingReadValue(data + i * value_size, value_size);
+    int64_t run_end = i + 1;
+    while (run_end < n_values && (run_end - i) < INT32_MAX &&
+           memcmp(data + run_end * value_size, data + i * value_size, value_size) == 0) {
+      run_end++;
+    }
+
+    result = ArrowEncodingAppendLE(out, run_end - i, sizeof(int32_t));
+    if (result == NANOARROW_OK) {
+      result = ArrowEncodingAppendLE(out, value, value_size);
+    }
+
+    if (result != NANOARROW_OK) {
+      out->size_bytes = out_size_bytes;
+      return result;
+    }
+
+    i = run_end;
+  }
+
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowBufferDecodeRunLength(struct ArrowBufferView encoded,
+                                          int64_t value_size, struct ArrowBuffer* out) {
+  if (!ArrowEncodingValidValueSize(value_size)) {
+    return EINVAL;
+  }
+
+  int64_t out_size_bytes = out->size_bytes;
+  uint64_t n_remaining;
+  int result = ArrowEncodingConsumeLE(&encoded, sizeof(int64_t), &n_remaining);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  while (n_remaining > 0) {
+    uint64_t run_length;
+    uint64_t value;
+    result = ArrowEncodingConsumeLE(&encoded, sizeof(int32_t), &run_length);
+    if (result == NANOARROW_OK) {
+      result = ArrowEncodingConsumeLE(&encoded, value_size, &value);
+    }
+
+    if (result == NANOARROW_OK &&
+        (run_length == 0 || run_length > INT32_MAX || run_length > n_remaining)) {
+      result = EINVAL;
+    }
+
+    if (result == NANOARROW_OK) {
+      result = ArrowBufferReserve(out, (int64_t)run_length * value_size);
+    }
+
+    if (result != NANOARROW_OK) {
+      out->size_bytes = out_size_bytes;
+      return result;
+    }
+
+    ArrowEncodingFillValues(out->data + out->size_bytes, value_size, (int64_t)value,
+                            (int64_t)run_length);
+    out->size_bytes += (int64_t)run_length * value_size;
+    n_remaining -= run_length;
+  }
+
+  if (encoded.size_bytes != 0) {
+    out->size_bytes = out_size_bytes;
+    return EINVAL;
+  }
+
+  return NANOARROW_OK;
+}
+
+static int ArrowEncodingBitWidth(uint64_t range) {
+  int bit_width = 0;
+  while (range != 0) {
+    bit_width++;
+    range >>= 1;
+  }
+
+  return bit_width;
+}
+
+// Unaligned little-endian 64-bit loads and stores for the bit packing loops
+static inline uint64_t ArrowEncodingLoad64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(uint64_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+static inline void ArrowEncodingStore64(uint8_t* data, uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  memcpy(data, &value, sizeof(uint64_t));
+}
+
+// The bit packing loops read and write whole 64-bit words at the byte where each
+// value starts, so they need this many bytes past the end of the packed bits
+#define NANOARROW_FOR_PACK_PADDING 8
+
+// Packs the difference between each value and reference into bit_width bits
+// each, least significant bit first, writing whole 64-bit words into memory with
+// NANOARROW_FOR_PACK_PADDING bytes to spare. Values are ORed into aligned words
+// on the stack (at most one block's worth) with no branches; alternating values
+// go to separate arrays so that consecutive values sharing a word do not wait on
+// each other's stores.
+static void ArrowEncodingPackBits(uint8_t* packed, const int64_t* values,
+                                  int64_t n_values, int64_t reference, int bit_width) {
+  uint64_t even[NANOARROW_FOR_BLOCK_SIZE + 1];
+  uint64_t odd[NANOARROW_FOR_BLOCK_SIZE + 1];
+  int64_t n_words = (n_values * bit_width + 63) / 64;
+  memset(even, 0, (n_words + 1) * sizeof(uint64_t));
+  memset(odd, 0, (n_words + 1) * sizeof(uint64_t));
+
+  int64_t i = 0;
+  for (; i + 1 < n_values; i += 2) {
+    uint64_t value = (uint64_t)values[i] - (uint64_t)reference;
+    int64_t bit = i * bit_width;
+    int shift = (int)(bit & 63);
+    even[bit >> 6] |= value << shift;
+    even[(bit >> 6) + 1] |= (value >> 1) >> (63 - shift);
+
+    value = (uint64_t)values[i + 1] - (uint64_t)reference;
+    bit += bit_width;
+    shift = (int)(bit & 63);
+    odd[bit >> 6] |= value << shift;
+    odd[(bit >> 6) + 1] |= (value >> 1) >> (63 - shift);
+  }
+
+  for (; i < n_values; i++) {
+    uint64_t value = (uint64_t)values[i] - (uint64_t)reference;
+    int64_t bit = i * bit_width;
+    int shift = (int)(bit & 63);
+    even[bit >> 6] |= value << shift;
+    even[(bit >> 6) + 1] |= (value >> 1) >> (63 - shift);
+  }
+
+  for (i = 0; i < n_words; i++) {
+    ArrowEncodingStore64(packed + i * sizeof(uint64_t), even[i] | odd[i]);
+  }
+}
+
+// Unpacks values written by ArrowEncodingPackBits(), which must be followed by
+// NANOARROW_FOR_PACK_PADDING readable bytes. Each value is a single unaligned
+// 64-bit load and a shift (plus one byte for bit widths above 57) with no
+// branches, so the iterations are independent of each other.
+static void ArrowEncodingUnpackBits(const uint8_t* packed, int64_t n_values,
+                                    int bit_width, int64_t reference,
+                                    int64_t* values_out) {
+  if (bit_width == 0) {
+    for (int64_t i = 0; i < n_values; i++) {
+      values_out[i] = reference;
+    }
+    return;
+  }
+
+  uint64_t mask = UINT64_MAX >> (64 - bit_width);
+  if (bit_width <= 57) {
+    for (int64_t i = 0; i < n_values; i++) {
+      int64_t bit = i * bit_width;
+      uint64_t value = ArrowEncodingLoad64(packed + (bit >> 3)) >> (bit & 7);
+      values_out[i] = (int64_t)((value & mask) + (uint64_t)reference);
+    }
+  } else {
+    for (int64_t i = 0; i < n_values; i++) {
+      int64_t bit = i * bit_width;
+      int shift = (int)(bit & 7);
+      const uint8_t* word = packed + (bit >> 3);
+      uint64_t value = (ArrowEncodingLoad64(word) >> shift) |
+                       (((uint64_t)word[8] << 1) << (63 - shift));
+      values_out[i] = (int64_t)((value & mask) + (uint64_t)reference);
+    }
+  }
+}
+
+static ArrowErrorCode ArrowEncodingAppendBlock(struct ArrowBuffer* out,
+                                               const int64_t* values, int64_t n_values) {
+  int64_t min_value = values[0];
+  int64_t max_value = values[0];
+  for (int64_t i = 1; i < n_values; i++) {
+    min_value = values[i] < min_value ? values[i] : min_value;
+    max_value = values[i] > max_value ? values[i] : max_value;
+  }
+
+  int bit_width = ArrowEncodingBitWidth((uint64_t)max_value - (uint64_t)min_value);
+  int64_t packed_size = (n_values * bit_width + 7) / 8;
+
+  // The padding is reserved but not part of the output
+  int result = ArrowBufferReserve(out, sizeof(int64_t) + 1 + packed_size +
+                                           NANOARROW_FOR_PACK_PADDING);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  ArrowEncodingStoreLE(out->data + out->size_bytes, (uint64_t)min_value,
+                       sizeof(int64_t));
+  out->data[out->size_bytes + sizeof(int64_t)] = (uint8_t)bit_width;
+  out->size_bytes += sizeof(int64_t) + 1;
+
+  ArrowEncodingPackBits(out->data + out->size_bytes, values, n_values, min_value,
+                        bit_width);
+  out->size_bytes += packed_size;
+  return NANOARROW_OK;
+}
+
+static ArrowErrorCode ArrowEncodingConsumeBlock(struct ArrowBufferView* encoded,
+                                                int64_t n_values, int64_t* values_out) {
+  uint64_t reference;
+  uint64_t bit_width;
+  int result = ArrowEncodingConsumeLE(encoded, sizeof(int64_t), &reference);
+  if (result == NANOARROW_OK) {
+    result = ArrowEncodingConsumeLE(encoded, 1, &bit_width);
+  }
+
+  if (result != NANOARROW_OK || bit_width > 64) {
+    return EINVAL;
+  }
+
+  int64_t packed_size = (n_values * (int64_t)bit_width + 7) / 8;
+  if (encoded->size_bytes < packed_size) {
+    return EINVAL;
+  }
+
+  // Blocks that are followed by at least the padding (i.e., all but the last
+  // block of a buffer) are unpacked in place; the last one is copied first
+  const uint8_t* packed = (const uint8_t*)encoded->data;
+  uint8_t padded[NANOARROW_FOR_BLOCK_SIZE * sizeof(int64_t) + NANOARROW_FOR_PACK_PADDING];
+  if ((encoded->size_bytes - packed_size) < NANOARROW_FOR_PACK_PADDING) {
+    memcpy(padded, packed, packed_size);
+    memset(padded + packed_size, 0, NANOARROW_FOR_PACK_PADDING);
+    packed = padded;
+  }
+
+  ArrowEncodingUnpackBits(packed, n_values, (int)bit_width, (int64_t)reference,
+                          values_out);
+  encoded->data = (const uint8_t*)encoded->data + packed_size;
+  encoded->size_bytes -= packed_size;
+  return NANOARROW_OK;
+}
+
+// Writes n_values (or, if delta is non-zero, the n_values - 1 differences
+// between consecutive values) as frame-of-reference encoded blocks
+static ArrowErrorCode ArrowEncodingAppendBlocks(struct ArrowBuffer* out,
+                                                const uint8_t* data, int64_t value_size,
+                                                int64_t n_values, int delta) {
+  int64_t block[NANOARROW_FOR_BLOCK_SIZE + 1];
+  int64_t n_encoded = delta ? n_values - 1 : n_values;
+
+  for (int64_t i = 0; i < n_encoded; i += NANOARROW_FOR_BLOCK_SIZE) {
+    int64_t n_block = n_encoded - i;
+    if (n_block > NANOARROW_FOR_BLOCK_SIZE) {
+      n_block = NANOARROW_FOR_BLOCK_SIZE;
+    }
+
+    if (delta) {
+      ArrowEncodingReadValues(data + i * value_size, value_size, block, n_block + 1);
+      for (int64_t j = 0; j < n_block; j++) {
+        block[j] = (int64_t)((uint64_t)block[j + 1] - (uint64_t)block[j]);
+      }
+    } else {
+      ArrowEncodingReadValues(data + i * value_size, value_size, block, n_block);
+    }
+
+    int result = ArrowEncodingAppendBlock(out, block, n_block);
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  return NANOARROW_OK;
+}
+
+// Reads the blocks written by ArrowEncodingAppendBlocks(). If delta is
+// non-zero, the decoded differences are accumulated starting from previous.
+static ArrowErrorCode ArrowEncodingConsumeBlocks(struct ArrowBufferView* encoded,
+                                                 int64_t n_encoded, int64_t value_size,
+                                                 struct ArrowBuffer* out, int delta,
+                                                 int64_t previous) {
+  int64_t block[NANOARROW_FOR_BLOCK_SIZE];
+
+  for (int64_t i = 0; i < n_encoded; i += NANOARROW_FOR_BLOCK_SIZE) {
+    int64_t n_block = n_encoded - i;
+    if (n_block > NANOARROW_FOR_BLOCK_SIZE) {
+      n_block = NANOARROW_FOR_BLOCK_SIZE;
+    }
+
+    int result = ArrowEncodingConsumeBlock(encoded, n_block, block);
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+
+    if (delta) {
+      for (int64_t j = 0; j < n_block; j++) {
+        previous = (int64_t)((uint64_t)previous + (uint64_t)block[j]);
+        block[j] = previous;
+      }
+    }
+
+    result = ArrowBufferReserve(out, n_block * value_size);
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+
+    ArrowEncodingWriteValues(out->data + out->size_bytes, value_size, block, n_block);
+    out->size_bytes += n_block * value_size;
+  }
+
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowBufferEncodeFrameOfReference(struct ArrowBufferView values,
+                                                 int64_t value_size,
+                                                 struct ArrowBuffer* out) {
+  int result = ArrowEncodingCheckValues(values, value_size);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  int64_t out_size_bytes = out->size_bytes;
+  int64_t n_values = values.size_bytes / value_size;
+
+  result = ArrowEncodingAppendLE(out, n_values, sizeof(int64_t));
+  if (result == NANOARROW_OK) {
+    result = ArrowEncodingAppendBlocks(out, (const uint8_t*)values.data, value_size,
+                                       n_values, 0);
+  }
+
+  if (result != NANOARROW_OK) {
+    out->size_bytes = out_size_bytes;
+  }
+
+  return result;
+}
+
+ArrowErrorCode ArrowBufferDecodeFrameOfReference(struct ArrowBufferView encoded,
+                                                 int64_t value_size,
+                                                 struct ArrowBuffer* out) {
+  if (!ArrowEncodingValidValueSize(value_size)) {
+    return EINVAL;
+  }
+
+  int64_t out_size_bytes = out->size_bytes;
+  uint64_t n_values;
+  int result = ArrowEncodingConsumeLE(&encoded, sizeof(int64_t), &n_values);
+  if (result == NANOARROW_OK && n_values > (uint64_t)(INT64_MAX / value_size)) {
+    result = EINVAL;
+  }
+
+  if (result == NANOARROW_OK) {
+    result = ArrowEncodingConsumeBlocks(&encoded, (int64_t)n_values, value_size, out, 0,
+                                        0);
+  }
+
+  if (result == NANOARROW_OK && encoded.size_bytes != 0) {
+    result = EINVAL;
+  }
+
+  if (result != NANOARROW_OK) {
+    out->size_bytes = out_size_bytes;
+  }
+
+  return result;
+}
+
+ArrowErrorCode ArrowBufferEncodeDelta(struct ArrowBufferView values, int64_t value_size,
+                                      struct ArrowBuffer* out) {
+  int result = ArrowEncodingCheckValues(values, value_size);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  int64_t out_size_bytes = out->size_bytes;
+  int64_t n_values = values.size_bytes / value_size;
+
+  result = ArrowEncodingAppendLE(out, n_values, sizeof(int64_t));
+  if (result == NANOARROW_OK && n_values > 0) {
+    int64_t first = ArrowEncodingReadValue((const uint8_t*)values.data, value_size);
+    result = ArrowEncodingAppendLE(out, (uint64_t)first, sizeof(int64_t));
+  }
+
+  if (result == NANOARROW_OK) {
+    result = ArrowEncodingAppendBlocks(out, (const uint8_t*)values.data, value_size,
+                                       n_values, 1);
+  }
+
+  if (result != NANOARROW_OK) {
+    out->size_bytes = out_size_bytes;
+  }
+
+  return result;
+}
+
+ArrowErrorCode ArrowBufferDecodeDelta(struct ArrowBufferView encoded, int64_t value_size,
+                                      struct ArrowBuffer* out) {
+  if (!ArrowEncodingValidValueSize(value_size)) {
+    return EINVAL;
+  }
+
+  int64_t out_size_bytes = out->size_bytes;
+  uint64_t n_values;
+  int result = ArrowEncodingConsumeLE(&encoded, sizeof(int64_t), &n_values);
+  if (result == NANOARROW_OK && n_values > (uint64_t)(INT64_MAX / value_size)) {
+    result = EINVAL;
+  }
+
+  if (result == NANOARROW_OK && n_values > 0) {
+    uint64_t first;
+    result = ArrowEncodingConsumeLE(&encoded, sizeof(int64_t), &first);
+    if (result == NANOARROW_OK) {
+      result = ArrowBufferReserve(out, value_size);
+    }
+
+    if (result == NANOARROW_OK) {
+      int64_t first_value = (int64_t)first;
+      ArrowEncodingWriteValues(out->data + out->size_bytes, value_size, &first_value, 1);
+      out->size_bytes += value_size;
+      result = ArrowEncodingConsumeBlocks(&encoded, (int64_t)n_values - 1, value_size,
+                                          out, 1, first_value);
+    }
+  }
+
+  if (result == NANOARROW_OK && encoded.size_bytes != 0) {
+    result = EINVAL;
+  }
+
+  if (result != NANOARROW_OK) {
+    out->size_bytes = out_size_bytes;
+  }
+
+  return result;
+}
@@ -0,0 +1,145 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+typedef ArrowErrorCode (*EncodeFunc)(struct ArrowBufferView, int64_t,
+                                     struct ArrowBuffer*);
+
+static const int64_t kNumValues = 1 << 20;
+
+// Microsecond event timestamps about one second apart with up to 1 ms of jitter
+static std::vector<int64_t> Timestamps() {
+  std::mt19937_64 rng(1234);
+  std::vector<int64_t> values(kNumValues);
+  for (int64_t i = 0; i < kNumValues; i++) {
+    values[i] = 1660000000000000 + i * 1000000 + static_cast<int64_t>(rng() % 1000);
+  }
+
+  return values;
+}
+
+// A low-cardinality status column with runs of up to 1000 values
+static std::vector<int64_t> StatusCodes() {
+  std::mt19937_64 rng(1234);
+  std::vector<int64_t> values(kNumValues);
+  for (int64_t i = 0; i < kNumValues;) {
+    int64_t value = 200 + static_cast<int64_t>(rng() % 5) * 100;
+    int64_t run_length = 1 + static_cast<int64_t>(rng() % 1000);
+    for (int64_t j = 0; j < run_length && i < kNumValues; j++, i++) {
+      values[i] = value;
+    }
+  }
+
+  return values;
+}
+
+// Unsorted quantities between 0 and 1000 stored as 64-bit integers
+static std::vector<int64_t> Quantities() {
+  std::mt19937_64 rng(1234);
+  std::vector<int64_t> values(kNumValues);
+  for (int64_t i = 0; i < kNumValues; i++) {
+    values[i] = static_cast<int64_t>(rng() % 1000);
+  }
+
+  return values;
+}
+
+// Reports encode throughput in terms of the unencoded bytes and the
+// compression ratio as the unencoded size over the encoded size
+static void BM_Encode(benchmark::State& state, EncodeFunc encode,
+                      std::vector<int64_t> (*make_values)()) {
+  std::vector<int64_t> values = make_values();
+  struct ArrowBufferView view = {values.data(),
+                                 static_cast<int64_t>(values.size() * sizeof(int64_t))};
+  struct ArrowBuffer encoded;
+  ArrowBufferInit(&encoded);
+
+  for (auto _ : state) {
+    encoded.size_bytes = 0;
+    if (encode(view, sizeof(int64_t), &encoded) != NANOARROW_OK) {
+      state.SkipWithError("encode failed");
+      break;
+    }
+    benchmark::DoNotOptimize(encoded.data);
+  }
+
+  state.SetBytesProcessed(state.iterations() * view.size_bytes);
+  state.counters["ratio"] = static_cast<double>(view.size_bytes) / encoded.size_bytes;
+  ArrowBufferReset(&encoded);
+}
+
+// Reports decode throughput in terms of the decoded bytes
+static void BM_Decode(benchmark::State& state, EncodeFunc encode, EncodeFunc decode,
+                      std::vector<int64_t> (*make_values)()) {
+  std::vector<int64_t> values = make_values();
+  struct ArrowBufferView view = {values.data(),
+                                 static_cast<int64_t>(values.size() * sizeof(int64_t))};
+  struct ArrowBuffer encoded;
+  ArrowBufferInit(&encoded);
+  struct ArrowBuffer decoded;
+  ArrowBufferInit(&decoded);
+  if (encode(view, sizeof(int64_t), &encoded) != NANOARROW_OK) {
+    state.SkipWithError("encode failed");
+  }
+
+  for (auto _ : state) {
+    decoded.size_bytes = 0;
+    if (decode({encoded.data, encoded.size_bytes}, sizeof(int64_t), &decoded) !=
+        NANOARROW_OK) {
+      state.SkipWithError("decode failed");
+      break;
+    }
+    benchmark::DoNotOptimize(decoded.data);
+  }
+
+  state.SetBytesProcessed(state.iterations() * view.size_bytes);
+  ArrowBufferReset(&encoded);
+  ArrowBufferReset(&decoded);
+}
+
+BENCHMARK_CAPTURE(BM_Encode, RunLength/Timestamps, &ArrowBufferEncodeRunLength,
+                  &Timestamps);
+BENCHMARK_CAPTURE(BM_Encode, RunLength/StatusCodes, &ArrowBufferEncodeRunLength,
+                  &StatusCodes);
+BENCHMARK_CAPTURE(BM_Encode, RunLength/Quantities, &ArrowBufferEncodeRunLength,
+                  &Quantities);
+BENCHMARK_CAPTURE(BM_Encode, FrameOfReference/Timestamps,
+                  &ArrowBufferEncodeFrameOfReference, &Timestamps);
+BENCHMARK_CAPTURE(BM_Encode, FrameOfReference/StatusCodes,
+                  &ArrowBufferEncodeFrameOfReference, &StatusCodes);
+BENCHMARK_CAPTURE(BM_Encode, FrameOfReference/Quantities,
+                  &ArrowBufferEncodeFrameOfReference, &Quantities);
+BENCHMARK_CAPTURE(BM_Encode, Delta/Timestamps, &ArrowBufferEncodeDelta, &Timestamps);
+BENCHMARK_CAPTURE(BM_Encode, Delta/StatusCodes, &ArrowBufferEncodeDelta, &StatusCodes);
+BENCHMARK_CAPTURE(BM_Encode, Delta/Quantities, &ArrowBufferEncodeDelta, &Quantities);
+
+BENCHMARK_CAPTURE(BM_Decode, RunLength/StatusCodes, &ArrowBufferEncodeRunLength,
+                  &ArrowBufferDecodeRunLength, &StatusCodes);
+BENCHMARK_CAPTURE(BM_Decode, FrameOfReference/Timestamps,
+                  &ArrowBufferEncodeFrameOfReference, &ArrowBufferDecodeFrameOfReference,
+                  &Timestamps);
+BENCHMARK_CAPTURE(BM_Decode, FrameOfReference/Quantities,
+                  &ArrowBufferEncodeFrameOfReference, &ArrowBufferDecodeFrameOfReference,
+                  &Quantities);
+BENCHMARK_CAPTURE(BM_Decode, Delta/Timestamps, &ArrowBufferEncodeDelta,
+                  &ArrowBufferDecodeDelta, &Timestamps);
@@ -0,0 +1,234 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+typedef ArrowErrorCode (*EncodeFunc)(struct ArrowBufferView, int64_t,
+                                     struct ArrowBuffer*);
+
+static const std::vector<std::pair<EncodeFunc, EncodeFunc>> kEncodings = {
+    {&ArrowBufferEncodeRunLength, &ArrowBufferDecodeRunLength},
+    {&ArrowBufferEncodeFrameOfReference, &ArrowBufferDecodeFrameOfReference},
+    {&ArrowBufferEncodeDelta, &ArrowBufferDecodeDelta}};
+
+// Encodes and decodes values with every encoding and returns the size of the
+// smallest encoding
+template <typename T>
+static int64_t ExpectRoundTrip(const std::vector<T>& values) {
+  struct ArrowBufferView view = {values.data(),
+                                 static_cast<int64_t>(values.size() * sizeof(T))};
+  int64_t min_size = std::numeric_limits<int64_t>::max();
+
+  for (const auto& encoding : kEncodings) {
+    struct ArrowBuffer encoded;
+    ArrowBufferInit(&encoded);
+    EXPECT_EQ(encoding.first(view, sizeof(T), &encoded), NANOARROW_OK);
+    min_size = std::min(min_size, encoded.size_bytes);
+
+    struct ArrowBuffer decoded;
+    ArrowBufferInit(&decoded);
+    EXPECT_EQ(
+        encoding.second({encoded.data, encoded.size_bytes}, sizeof(T), &decoded),
+        NANOARROW_OK);
+    EXPECT_EQ(decoded.size_bytes, view.size_bytes);
+    if (decoded.size_bytes == view.size_bytes && view.size_bytes > 0) {
+      EXPECT_EQ(memcmp(decoded.data, values.data(), view.size_bytes), 0);
+    }
+
+    ArrowBufferReset(&encoded);
+    ArrowBufferReset(&decoded);
+  }
+
+  return min_size;
+}
+
+TEST(EncodingTest, EncodingTestRoundTripEmpty) {
+  ExpectRoundTrip(std::vector<int8_t>());
+  ExpectRoundTrip(std::vector<int64_t>());
+}
+
+TEST(EncodingTest, EncodingTestRoundTripWidths) {
+  // Lengths around the block size with a mix of runs, small and large values
+  for (int64_t n : {1, 2, 127, 128, 129, 300}) {
+    std::vector<int8_t> values8;
+    std::vector<int16_t> values16;
+    std::vector<int32_t> values32;
+    std::vector<int64_t> values64;
+    for (int64_t i = 0; i < n; i++) {
+      int64_t value = (i / 7) * ((i % 3) - 1) * 37;
+      values8.push_back(static_cast<int8_t>(value));
+      values16.push_back(static_cast<int16_t>(value * 100));
+      values32.push_back(static_cast<int32_t>(value * 100000));
+      values64.push_back(value * 10000000000);
+    }
+
+    ExpectRoundTrip(values8);
+    ExpectRoundTrip(values16);
+    ExpectRoundTrip(values32);
+    ExpectRoundTrip(values64);
+  }
+}
+
+TEST(EncodingTest, EncodingTestRoundTripExtremes) {
+  // Differences that span the whole 64-bit range wrap around
+  std::vector<int64_t> values64 = {std::numeric_limits<int64_t>::min(),
+                                   std::numeric_limits<int64_t>::max(), 0, -1,
+                                   std::numeric_limits<int64_t>::min()};
+  ExpectRoundTrip(values64);
+
+  std::vector<int32_t> values32 = {std::numeric_limits<int32_t>::min(),
+                                   std::numeric_limits<int32_t>::max(), 0, -1};
+  ExpectRoundTrip(values32);
+
+  std::vector<int8_t> values8 = {-128, 127, 0, -1, -128};
+  ExpectRoundTrip(values8);
+
+  // Every bit width, with a pattern that sets bits at every offset within a
+  // byte and enough blocks that some are unpacked in place
+  uint64_t state = 1;
+  for (int bit_width = 0; bit_width < 64; bit_width++) {
+    uint64_t mask = (uint64_t{1} << bit_width) - 1;
+    std::vector<int64_t> values;
+    for (int64_t i = 0; i < 300; i++) {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      values.push_back(static_cast<int64_t>(i % 2 ? mask : (state >> 1) & mask));
+    }
+
+    ExpectRoundTrip(values);
+  }
+}
+
+TEST(EncodingTest, EncodingTestCompression) {
+  // A sorted timestamp column with a regular interval and some jitter
+  std::vector<int64_t> timestamps;
+  for (int64_t i = 0; i < 10000; i++) {
+    timestamps.push_back(1660000000000000 + i * 1000000 + (i * 7919) % 1000);
+  }
+  int64_t delta_size = ExpectRoundTrip(timestamps);
+  EXPECT_LT(delta_size, static_cast<int64_t>(timestamps.size() * sizeof(int64_t)) / 3);
+
+  // A low-cardinality column with long runs
+  std::vector<int32_t> runs;
+  for (int64_t i = 0; i < 10000; i++) {
+    runs.push_back(static_cast<int32_t>(i / 1000));
+  }
+  int64_t rle_size = ExpectRoundTrip(runs);
+  EXPECT_LE(rle_size, 8 + 10 * 8);
+
+  // Small values in a wide type
+  std::vector<int64_t> small;
+  for (int64_t i = 0; i < 10000; i++) {
+    small.push_back(1000 + (i * 7919) % 16);
+  }
+  int64_t for_size = ExpectRoundTrip(small);
+  EXPECT_LT(for_size, static_cast<int64_t>(small.size() * sizeof(int64_t)) / 10);
+}
+
+// The size of an encoded frame-of-reference block: its minimum, its bit
+// width, and the bit-packed differences from the minimum
+static int64_t BlockSize(int64_t n_values, int64_t bit_width) {
+  return sizeof(int64_t) + 1 + (n_values * bit_width + 7) / 8;
+}
+
+TEST(EncodingTest, EncodingTestTimestampCompression) {
+  // 10000 microsecond timestamps one second apart, alternately 1 ms late, are
+  // 78 full blocks of 128 values and a last block of 16 values
+  std::vector<int64_t> timestamps;
+  for (int64_t i = 0; i < 10000; i++) {
+    timestamps.push_back(1660000000000000 + i * 1000000 + (i % 2) * 1000);
+  }
+  struct ArrowBufferView view = {timestamps.data(),
+                                 static_cast<int64_t>(timestamps.size() * 8)};
+  ExpectRoundTrip(timestamps);
+
+  struct ArrowBuffer encoded;
+  ArrowBufferInit(&encoded);
+
+  // Each full block spans 127 s and 1 ms (27 bits); the last spans 15 s and
+  // 1 ms (24 bits)
+  ASSERT_EQ(ArrowBufferEncodeFrameOfReference(view, sizeof(int64_t), &encoded),
+            NANOARROW_OK);
+  EXPECT_EQ(encoded.size_bytes, 8 + 78 * BlockSize(128, 27) + BlockSize(16, 24));
+  encoded.size_bytes = 0;
+
+  // The 9999 differences alternate between 1 s + 1 ms and 1 s - 1 ms, a range
+  // of 2 ms (11 bits), so delta encoding is about 5.5 times smaller than the
+  // values
+  ASSERT_EQ(ArrowBufferEncodeDelta(view, sizeof(int64_t), &encoded), NANOARROW_OK);
+  EXPECT_EQ(encoded.size_bytes, 8 + 8 + 78 * BlockSize(128, 11) + BlockSize(15, 11));
+  EXPECT_LT(encoded.size_bytes * 5, view.size_bytes);
+  encoded.size_bytes = 0;
+
+  // Exactly regular timestamps have constant differences that need no bits
+  for (int64_t i = 0; i < 10000; i++) {
+    timestamps[i] = 1660000000000000 + i * 1000000;
+  }
+  ASSERT_EQ(ArrowBufferEncodeDelta(view, sizeof(int64_t), &encoded), NANOARROW_OK);
+  EXPECT_EQ(encoded.size_bytes, 8 + 8 + 79 * BlockSize(128, 0));
+  ArrowBufferReset(&encoded);
+  ExpectRoundTrip(timestamps);
+}
+
+TEST(EncodingTest, EncodingTestErrors) {
+  struct ArrowBuffer out;
+  ArrowBufferInit(&out);
+  ASSERT_EQ(ArrowBufferAppend(&out, "abc", 3), NANOARROW_OK);
+
+  int32_t values[] = {1, 2, 3};
+  for (const auto& encoding : kEncodings) {
+    EXPECT_EQ(encoding.first({values, 12}, 3, &out), EINVAL);
+    EXPECT_EQ(encoding.first({values, 11}, 4, &out), EINVAL);
+    EXPECT_EQ(encoding.second({values, 12}, 3, &out), EINVAL);
+
+    // Truncated input leaves out as it was
+    struct ArrowBuffer encoded;
+    ArrowBufferInit(&encoded);
+    ASSERT_EQ(encoding.first({values, 12}, 4, &encoded), NANOARROW_OK);
+    for (int64_t size = 1; size < encoded.size_bytes; size++) {
+      EXPECT_EQ(encoding.second({encoded.data, size}, 4, &out), EINVAL)
+          << "size " << size;
+      EXPECT_EQ(out.size_bytes, 3);
+    }
+
+    ArrowBufferReset(&encoded);
+  }
+
+  // A zero-length run
+  uint8_t zero_run[] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+  EXPECT_EQ(ArrowBufferDecodeRunLength({zero_run, 13}, 1, &out), EINVAL);
+
+  // Trailing bytes
+  uint8_t trailing[] = {0, 0, 0, 0, 0, 0, 0, 0, 1};
+  for (const auto& encoding : kEncodings) {
+    EXPECT_EQ(encoding.second({trailing, 9}, 1, &out), EINVAL);
+  }
+
+  // A bit width over 64
+  uint8_t bad_width[] = {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 65};
+  EXPECT_EQ(ArrowBufferDecodeFrameOfReference({bad_width, 17}, 1, &out), EINVAL);
+
+  EXPECT_EQ(out.size_bytes, 3);
+  ArrowBufferReset(&out);
+}
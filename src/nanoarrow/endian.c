@@ -0,0 +1,401 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <errno.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "nanoarrow.h"
+
+static int ArrowByteSwapValidValueSize(int64_t value_size) {
+  return value_size == 2 || value_size == 4 || value_size == 8 || value_size == 16 ||
+         value_size == 32;
+}
+
+static inline uint16_t ArrowByteSwap16(uint16_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_bswap16(value);
+#else
+  return (uint16_t)((value << 8) | (value >> 8));
+#endif
+}
+
+static inline uint32_t ArrowByteSwap32(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_bswap32(value);
+#else
+  return ((value & 0x000000FF) << 24) | ((value & 0x0000FF00) << 8) |
+         ((value & 0x00FF0000) >> 8) | ((value & 0xFF000000) >> 24);
+#endif
+}
+
+static inline uint64_t ArrowByteSwap64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_bswap64(value);
+#else
+  return ((uint64_t)ArrowByteSwap32((uint32_t)value) << 32) |
+         ArrowByteSwap32((uint32_t)(value >> 32));
+#endif
+}
+
+// Swaps values one at a time. For 16- and 32-byte values every word is loaded
+// before any is stored so that this also works in place.
+static void ArrowByteSwapScalar(uint8_t* out, const uint8_t* values, int64_t n_values,
+                                int64_t value_size) {
+  switch (value_size) {
+    case 2:
+      for (int64_t i = 0; i < n_values; i++) {
+        uint16_t value;
+        memcpy(&value, values + i * 2, sizeof(uint16_t));
+        value = ArrowByteSwap16(value);
+        memcpy(out + i * 2, &value, sizeof(uint16_t));
+      }
+      break;
+    case 4:
+      for (int64_t i = 0; i < n_values; i++) {
+        uint32_t value;
+        memcpy(&value, values + i * 4, sizeof(uint32_t));
+        value = ArrowByteSwap32(value);
+        memcpy(out + i * 4, &value, sizeof(uint32_t));
+      }
+      break;
+    case 8:
+      for (int64_t i = 0; i < n_values; i++) {
+        uint64_t value;
+        memcpy(&value, values + i * 8, sizeof(uint64_t));
+        value = ArrowByteSwap64(value);
+        memcpy(out + i * 8, &value, sizeof(uint64_t));
+      }
+      break;
+    case 16:
+      for (int64_t i = 0; i < n_values; i++) {
+        uint64_t lo, hi;
+        memcpy(&lo, values + i * 16, sizeof(uint64_t));
+        memcpy(&hi, values + i * 16 + 8, sizeof(uint64_t));
+        lo = ArrowByteSwap64(lo);
+        hi = ArrowByteSwap64(hi);
+        memcpy(out + i * 16, &hi, sizeof(uint64_t));
+        memcpy(out + i * 16 + 8, &lo, sizeof(uint64_t));
+      }
+      break;
+    default:
+      for (int64_t i = 0; i < n_values; i++) {
+        uint64_t w0, w1, w2, w3;
+        memcpy(&w0, values + i * 32, sizeof(uint64_t));
+        memcpy(&w1, values + i * 32 + 8, sizeof(uint64_t));
+        memcpy(&w2, values + i * 32 + 16, sizeof(uint64_t));
+        memcpy(&w3, values + i * 32 + 24, sizeof(uint64_t));
+        w0 = ArrowByteSwap64(w0);
+        w1 = ArrowByteSwap64(w1);
+        w2 = ArrowByteSwap64(w2);
+        w3 = ArrowByteSwap64(w3);
+        memcpy(out + i * 32, &w3, sizeof(uint64_t));
+        memcpy(out + i * 32 + 8, &w2, sizeof(uint64_t));
+        memcpy(out + i * 32 + 16, &w1, sizeof(uint64_t));
+        memcpy(out + i * 32 + 24, &w0, sizeof(uint64_t));
+      }
+      break;
+  }
+}
+
+#if defined(__AVX2__) || defined(__SSSE3__) || \
+    (defined(__ARM_NEON) && defined(__aarch64__))
+
+// The shuffle that reverses each value_size-byte group within a 16-byte lane.
+// 32-byte values are reversed within each half and then have their halves
+// exchanged.
+static void ArrowByteSwapShuffle(uint8_t* shuffle, int64_t value_size) {
+  int lane_value_size = value_size > 16 ? 16 : (int)value_size;
+  for (int j = 0; j < 16; j++) {
+    shuffle[j] = (uint8_t)((j / lane_value_size) * lane_value_size +
+                           (lane_value_size - 1 - j % lane_value_size));
+  }
+}
+
+// Swaps whole 32-byte blocks and returns the number of values swapped. Each
+// block is loaded before it is stored so that this also works in place.
+static int64_t ArrowByteSwapVector(uint8_t* out, const uint8_t* values, int64_t n_values,
+                                   int64_t value_size) {
+  uint8_t shuffle_bytes[16];
+  ArrowByteSwapShuffle(shuffle_bytes, value_size);
+  int64_t n_blocks = n_values * value_size / 32;
+
+#if defined(__AVX2__)
+  __m256i shuffle =
+      _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)shuffle_bytes));
+  if (value_size == 32) {
+    for (int64_t i = 0; i < n_blocks; i++) {
+      __m256i block = _mm256_loadu_si256((const __m256i*)(values + i * 32));
+      block = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(block, shuffle), 0x4E);
+      _mm256_storeu_si256((__m256i*)(out + i * 32), block);
+    }
+  } else {
+    for (int64_t i = 0; i < n_blocks; i++) {
+      __m256i block = _mm256_loadu_si256((const __m256i*)(values + i * 32));
+      _mm256_storeu_si256((__m256i*)(out + i * 32), _mm256_shuffle_epi8(block, shuffle));
+    }
+  }
+#elif defined(__SSSE3__)
+  __m128i shuffle = _mm_loadu_si128((const __m128i*)shuffle_bytes);
+  int64_t first = value_size == 32 ? 16 : 0;
+  for (int64_t i = 0; i < n_blocks; i++) {
+    __m128i lo = _mm_loadu_si128((const __m128i*)(values + i * 32));
+    __m128i hi = _mm_loadu_si128((const __m128i*)(values + i * 32 + 16));
+    _mm_storeu_si128((__m128i*)(out + i * 32 + first), _mm_shuffle_epi8(lo, shuffle));
+    _mm_storeu_si128((__m128i*)(out + i * 32 + 16 - first),
+                     _mm_shuffle_epi8(hi, shuffle));
+  }
+#else
+  uint8x16_t shuffle = vld1q_u8(shuffle_bytes);
+  int64_t first = value_size == 32 ? 16 : 0;
+  for (int64_t i = 0; i < n_blocks; i++) {
+    uint8x16_t lo = vld1q_u8(values + i * 32);
+    uint8x16_t hi = vld1q_u8(values + i * 32 + 16);
+    vst1q_u8(out + i * 32 + first, vqtbl1q_u8(lo, shuffle));
+    vst1q_u8(out + i * 32 + 16 - first, vqtbl1q_u8(hi, shuffle));
+  }
+#endif
+
+  return n_blocks * 32 / value_size;
+}
+
+#elif defined(__SSE2__)
+
+// Without a byte shuffle, bytes are swapped within 16-bit lanes using shifts
+// after wider lanes are reversed 16 bits at a time
+static inline __m128i ArrowByteSwapSSE2(__m128i block, int64_t value_size) {
+  switch (value_size) {
+    case 2:
+      break;
+    case 4:
+      block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, 0xB1), 0xB1);
+      break;
+    default:
+      block = _mm_shufflehi_epi16(_mm_shufflelo_epi16(block, 0x1B), 0x1B);
+      if (value_size > 8) {
+        block = _mm_shuffle_epi32(block, 0x4E);
+      }
+      break;
+  }
+
+  return _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+}
+
+static int64_t ArrowByteSwapVector(uint8_t* out, const uint8_t* values, int64_t n_values,
+                                   int64_t value_size) {
+  int64_t n_blocks = n_values * value_size / 32;
+  int64_t first = value_size == 32 ? 16 : 0;
+  for (int64_t i = 0; i < n_blocks; i++) {
+    __m128i lo = _mm_loadu_si128((const __m128i*)(values + i * 32));
+    __m128i hi = _mm_loadu_si128((const __m128i*)(values + i * 32 + 16));
+    _mm_storeu_si128((__m128i*)(out + i * 32 + first), ArrowByteSwapSSE2(lo, value_size));
+    _mm_storeu_si128((__m128i*)(out + i * 32 + 16 - first),
+                     ArrowByteSwapSSE2(hi, value_size));
+  }
+
+  return n_blocks * 32 / value_size;
+}
+
+#else
+
+static int64_t ArrowByteSwapVector(uint8_t* out, const uint8_t* values, int64_t n_values,
+                                   int64_t value_size) {
+  return 0;
+}
+
+#endif
+
+ArrowErrorCode ArrowByteSwap(void* out, const void* values, int64_t n_values,
+                             int64_t value_size) {
+  if (!ArrowByteSwapValidValueSize(value_size) || n_values < 0) {
+    return EINVAL;
+  }
+
+  int64_t n_swapped =
+      ArrowByteSwapVector((uint8_t*)out, (const uint8_t*)values, n_values, value_size);
+  ArrowByteSwapScalar((uint8_t*)out + n_swapped * value_size,
+                      (const uint8_t*)values + n_swapped * value_size,
+                      n_values - n_swapped, value_size);
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowBufferByteSwap(struct ArrowBuffer* buffer, int64_t value_size) {
+  if (!ArrowByteSwapValidValueSize(value_size) ||
+      (buffer->size_bytes % value_size) != 0) {
+    return EINVAL;
+  }
+
+  return ArrowByteSwap(buffer->data, buffer->data, buffer->size_bytes / value_size,
+                       value_size);
+}
+
+ArrowErrorCode ArrowBufferAppendByteSwapped(struct ArrowBuffer* buffer,
+                                            struct ArrowBufferView values,
+                                            int64_t value_size) {
+  if (!ArrowByteSwapValidValueSize(value_size) ||
+      (values.size_bytes % value_size) != 0) {
+    return EINVAL;
+  }
+
+  int result = ArrowBufferReserve(buffer, values.size_bytes);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  ArrowByteSwap(buffer->data + buffer->size_bytes, values.data,
+                values.size_bytes / value_size, value_size);
+  buffer->size_bytes += values.size_bytes;
+  return NANOARROW_OK;
+}
+
+// A month_day_nano interval is an int32, an int32 and an int64, each of which
+// is swapped separately
+static void ArrowByteSwapMonthDayNano(uint8_t* data, int64_t n_values) {
+  for (int64_t i = 0; i < n_values; i++) {
+    ArrowByteSwapScalar(data + i * 16, data + i * 16, 2, sizeof(int32_t));
+    ArrowByteSwapScalar(data + i * 16 + 8, data + i * 16 + 8, 1, sizeof(int64_t));
+  }
+}
+
+static ArrowErrorCode ArrowArrayByteSwapBuffers(struct ArrowArray* array,
+                                                struct ArrowSchemaView* schema_view) {
+  int64_t n_values = array->offset + array->length;
+
+  if (schema_view->offset_buffer_id >= 0 &&
+      array->buffers[schema_view->offset_buffer_id] != NULL && n_values > 0) {
+    uint8_t* offsets = (uint8_t*)array->buffers[schema_view->offset_buffer_id];
+    switch (schema_view->storage_data_type) {
+      case NANOARROW_TYPE_DENSE_UNION:
+        ArrowByteSwap(offsets, offsets, n_values, sizeof(int32_t));
+        break;
+      case NANOARROW_TYPE_LARGE_STRING:
+      case NANOARROW_TYPE_LARGE_BINARY:
+      case NANOARROW_TYPE_LARGE_LIST:
+        ArrowByteSwap(offsets, offsets, n_values + 1, sizeof(int64_t));
+        break;
+      default:
+        ArrowByteSwap(offsets, offsets, n_values + 1, sizeof(int32_t));
+        break;
+    }
+  }
+
+  if (schema_view->data_buffer_id < 0 ||
+      array->buffers[schema_view->data_buffer_id] == NULL || n_values == 0) {
+    return NANOARROW_OK;
+  }
+
+  uint8_t* data = (uint8_t*)array->buffers[schema_view->data_buffer_id];
+  switch (schema_view->storage_data_type) {
+    case NANOARROW_TYPE_UINT16:
+    case NANOARROW_TYPE_INT16:
+    case NANOARROW_TYPE_HALF_FLOAT:
+      return ArrowByteSwap(data, data, n_values, 2);
+    case NANOARROW_TYPE_UINT32:
+    case NANOARROW_TYPE_INT32:
+    case NANOARROW_TYPE_FLOAT:
+    case NANOARROW_TYPE_INTERVAL_MONTHS:
+      return ArrowByteSwap(data, data, n_values, 4);
+    case NANOARROW_TYPE_INTERVAL_DAY_TIME:
+      return ArrowByteSwap(data, data, n_values * 2, 4);
+    case NANOARROW_TYPE_UINT64:
+    case NANOARROW_TYPE_INT64:
+    case NANOARROW_TYPE_DOUBLE:
+      return ArrowByteSwap(data, data, n_values, 8);
+    case NANOARROW_TYPE_DECIMAL128:
+      return ArrowByteSwap(data, data, n_values, 16);
+    case NANOARROW_TYPE_DECIMAL256:
+      return ArrowByteSwap(data, data, n_values, 32);
+    case NANOARROW_TYPE_INTERVAL_MONTH_DAY_NANO:
+      ArrowByteSwapMonthDayNano(data, n_values);
+      return NANOARROW_OK;
+    default:
+      // Bitmaps, single bytes and variable-length data have no byte order
+      return NANOARROW_OK;
+  }
+}
+
+// Checks the whole tree before anything is swapped so that an invalid array is
+// left untouched
+static ArrowErrorCode ArrowArrayByteSwapInternal(struct ArrowArray* array,
+                                                 struct ArrowSchema* schema,
+                                                 char validate_only,
+                                                 struct ArrowError* error) {
+  struct ArrowSchemaView schema_view;
+  int result = ArrowSchemaViewInit(&schema_view, schema, error);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  if (array->n_buffers != schema_view.n_buffers) {
+    ArrowErrorSet(error, "Expected array with %d buffer(s) but found %d buffer(s)",
+                  (int)schema_view.n_buffers, (int)array->n_buffers);
+    return EINVAL;
+  }
+
+  if (array->n_children != schema->n_children) {
+    ArrowErrorSet(error, "Expected array with %d child(ren) but found %d child(ren)",
+                  (int)schema->n_children, (int)array->n_children);
+    return EINVAL;
+  }
+
+  if ((array->dictionary == NULL) != (schema->dictionary == NULL)) {
+    ArrowErrorSet(error, "Expected array dictionary to be %s",
+                  schema->dictionary == NULL ? "NULL" : "non-NULL");
+    return EINVAL;
+  }
+
+  if (!validate_only) {
+    result = ArrowArrayByteSwapBuffers(array, &schema_view);
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  for (int64_t i = 0; i < array->n_children; i++) {
+    result = ArrowArrayByteSwapInternal(array->children[i], schema->children[i],
+                                        validate_only, error);
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  if (array->dictionary != NULL) {
+    return ArrowArrayByteSwapInternal(array->dictionary, schema->dictionary,
+                                      validate_only, error);
+  }
+
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowArrayByteSwap(struct ArrowArray* array, struct ArrowSchema* schema,
+                                  struct ArrowError* error) {
+  int result = ArrowArrayByteSwapInternal(array, schema, 1, error);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  return ArrowArrayByteSwapInternal(array, schema, 0, error);
+}
@@ -0,0 +1,78 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <algorithm>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+// Benchmarks take the value size and the number of bytes to swap
+static void ByteSwapArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t value_size : {2, 4, 8, 16, 32}) {
+    benchmark->Args({value_size, 1 << 20});
+  }
+
+  benchmark->Args({8, 1 << 26});
+}
+
+// The element-by-element loop that ArrowByteSwap() replaces
+static void BM_ByteSwapScalar(benchmark::State& state) {
+  int64_t value_size = state.range(0);
+  std::vector<uint8_t> values(state.range(1), 1);
+  std::vector<uint8_t> out(values.size());
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < values.size(); i += value_size) {
+      std::reverse_copy(values.data() + i, values.data() + i + value_size,
+                        out.data() + i);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_ByteSwap(benchmark::State& state) {
+  int64_t value_size = state.range(0);
+  std::vector<uint8_t> values(state.range(1), 1);
+  std::vector<uint8_t> out(values.size());
+
+  for (auto _ : state) {
+    ArrowByteSwap(out.data(), values.data(), values.size() / value_size, value_size);
+    benchmark::DoNotOptimize(out.data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+static void BM_ByteSwapInPlace(benchmark::State& state) {
+  int64_t value_size = state.range(0);
+  std::vector<uint8_t> values(state.range(1), 1);
+
+  for (auto _ : state) {
+    ArrowByteSwap(values.data(), values.data(), values.size() / value_size, value_size);
+    benchmark::DoNotOptimize(values.data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(BM_ByteSwapScalar)->Apply(ByteSwapArgs);
+BENCHMARK(BM_ByteSwap)->Apply(ByteSwapArgs);
+BENCHMARK(BM_ByteSwapInPlace)->Apply(ByteSwapArgs);
@@ -0,0 +1,293 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+// Reverses each value_size-byte value one byte at a time
+static std::vector<uint8_t> ReverseEach(const std::vector<uint8_t>& values,
+                                       int64_t value_size) {
+  std::vector<uint8_t> out(values);
+  for (size_t i = 0; i + value_size <= out.size(); i += value_size) {
+    std::reverse(out.begin() + i, out.begin() + i + value_size);
+  }
+  return out;
+}
+
+static std::vector<uint8_t> Iota(int64_t n_bytes) {
+  std::vector<uint8_t> values(n_bytes);
+  for (int64_t i = 0; i < n_bytes; i++) {
+    values[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+  return values;
+}
+
+TEST(EndianTest, ByteSwap) {
+  for (int64_t value_size : {2, 4, 8, 16, 32}) {
+    // Lengths around the vector block size, at an unaligned address
+    for (int64_t n_values = 0; n_values < 40; n_values++) {
+      std::vector<uint8_t> values = Iota(n_values * value_size);
+      std::vector<uint8_t> expected = ReverseEach(values, value_size);
+
+      std::vector<uint8_t> out(values.size() + 1);
+      ASSERT_EQ(ArrowByteSwap(out.data() + 1, values.data(), n_values, value_size),
+                NANOARROW_OK);
+      EXPECT_TRUE(std::equal(expected.begin(), expected.end(), out.begin() + 1));
+
+      // In place
+      std::vector<uint8_t> in_place(values);
+      ASSERT_EQ(ArrowByteSwap(in_place.data(), in_place.data(), n_values, value_size),
+                NANOARROW_OK);
+      EXPECT_EQ(in_place, expected);
+      ASSERT_EQ(ArrowByteSwap(in_place.data(), in_place.data(), n_values, value_size),
+                NANOARROW_OK);
+      EXPECT_EQ(in_place, values);
+    }
+  }
+
+  uint8_t value[64];
+  for (int64_t value_size : {0, 1, 3, 12, 64}) {
+    EXPECT_EQ(ArrowByteSwap(value, value, 1, value_size), EINVAL);
+  }
+  EXPECT_EQ(ArrowByteSwap(value, value, -1, 4), EINVAL);
+}
+
+TEST(EndianTest, ByteSwapKnownValues) {
+  uint32_t value32 = 0x01020304;
+  ASSERT_EQ(ArrowByteSwap(&value32, &value32, 1, sizeof(uint32_t)), NANOARROW_OK);
+  EXPECT_EQ(value32, 0x04030201u);
+
+  uint64_t value64 = 0x0102030405060708;
+  ASSERT_EQ(ArrowByteSwap(&value64, &value64, 1, sizeof(uint64_t)), NANOARROW_OK);
+  EXPECT_EQ(value64, 0x0807060504030201u);
+
+  // A decimal128 value is reversed as a whole, so its words change places
+  uint64_t decimal128[2] = {0x0102030405060708, 0x1112131415161718};
+  ASSERT_EQ(ArrowByteSwap(decimal128, decimal128, 1, 16), NANOARROW_OK);
+  EXPECT_EQ(decimal128[0], 0x1817161514131211u);
+  EXPECT_EQ(decimal128[1], 0x0807060504030201u);
+}
+
+TEST(EndianTest, BufferByteSwap) {
+  struct ArrowBuffer buffer;
+  ArrowBufferInit(&buffer);
+
+  std::vector<uint8_t> values = Iota(1000 * 8);
+  struct ArrowBufferView view = {values.data(), static_cast<int64_t>(values.size())};
+  ASSERT_EQ(ArrowBufferAppendByteSwapped(&buffer, view, 8), NANOARROW_OK);
+  ASSERT_EQ(buffer.size_bytes, view.size_bytes);
+  std::vector<uint8_t> expected = ReverseEach(values, 8);
+  EXPECT_EQ(memcmp(buffer.data, expected.data(), expected.size()), 0);
+
+  ASSERT_EQ(ArrowBufferByteSwap(&buffer, 8), NANOARROW_OK);
+  EXPECT_EQ(memcmp(buffer.data, values.data(), values.size()), 0);
+
+  // Sizes that are not a multiple of value_size
+  EXPECT_EQ(ArrowBufferByteSwap(&buffer, 16), NANOARROW_OK);
+  EXPECT_EQ(ArrowBufferByteSwap(&buffer, 3), EINVAL);
+  ASSERT_EQ(ArrowBufferAppendUInt8(&buffer, 0), NANOARROW_OK);
+  EXPECT_EQ(ArrowBufferByteSwap(&buffer, 2), EINVAL);
+  view.size_bytes = 7;
+  EXPECT_EQ(ArrowBufferAppendByteSwapped(&buffer, view, 2), EINVAL);
+  EXPECT_EQ(buffer.size_bytes, 1000 * 8 + 1);
+
+  ArrowBufferReset(&buffer);
+}
+
+// A struct<int32, large_string, decimal128, interval_month_day_nano,
+// dictionary<int16, string>> array with length 2 and an offset of 1
+TEST(EndianTest, ArrayByteSwap) {
+  struct ArrowSchema schema;
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(&schema, 5), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[0], NANOARROW_TYPE_INT32), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[1], NANOARROW_TYPE_LARGE_STRING),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInitDecimal(schema.children[2], NANOARROW_TYPE_DECIMAL128, 10, 2),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[3], NANOARROW_TYPE_INTERVAL_MONTH_DAY_NANO),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[4], NANOARROW_TYPE_INT16), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateDictionary(schema.children[4]), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[4]->dictionary, NANOARROW_TYPE_STRING),
+            NANOARROW_OK);
+
+  // Everything is written as if it came from a big-endian platform
+  int32_t int32s[] = {0x01000000, 0x02000000, 0x03000000};
+  int64_t large_offsets[] = {0, 0x0100000000000000, 0x0300000000000000,
+                             0x0600000000000000};
+  char large_data[] = "abcdef";
+  uint64_t decimals[] = {0, 0x0100000000000000, 0, 0x0200000000000000,
+                         0, 0x0300000000000000};
+  uint8_t month_day_nano[3 * 16] = {0};
+  for (int i = 0; i < 3; i++) {
+    month_day_nano[i * 16 + 3] = 1;
+    month_day_nano[i * 16 + 7] = 2;
+    month_day_nano[i * 16 + 15] = 3;
+  }
+  int16_t indices[] = {0x0000, 0x0100, 0x0000};
+  int32_t dictionary_offsets[] = {0, 0x03000000, 0x06000000};
+  char dictionary_data[] = "onetwo";
+
+  const void* int32_buffers[] = {nullptr, int32s};
+  const void* large_string_buffers[] = {nullptr, large_offsets, large_data};
+  const void* decimal_buffers[] = {nullptr, decimals};
+  const void* month_day_nano_buffers[] = {nullptr, month_day_nano};
+  const void* index_buffers[] = {nullptr, indices};
+  const void* dictionary_buffers[] = {nullptr, dictionary_offsets, dictionary_data};
+  const void* struct_buffers[] = {nullptr};
+
+  struct ArrowArray children[5];
+  const void** children_buffers[] = {int32_buffers, large_string_buffers,
+                                     decimal_buffers, month_day_nano_buffers,
+                                     index_buffers};
+  struct ArrowArray* children_ptrs[5];
+  for (int i = 0; i < 5; i++) {
+    memset(&children[i], 0, sizeof(struct ArrowArray));
+    children[i].length = 2;
+    children[i].offset = 1;
+    children[i].n_buffers = 2;
+    children[i].buffers = children_buffers[i];
+    children_ptrs[i] = &children[i];
+  }
+  children[1].n_buffers = 3;
+
+  struct ArrowArray dictionary;
+  memset(&dictionary, 0, sizeof(struct ArrowArray));
+  dictionary.length = 2;
+  dictionary.n_buffers = 3;
+  dictionary.buffers = dictionary_buffers;
+  children[4].dictionary = &dictionary;
+
+  struct ArrowArray array;
+  memset(&array, 0, sizeof(struct ArrowArray));
+  array.length = 2;
+  array.n_buffers = 1;
+  array.buffers = struct_buffers;
+  array.n_children = 5;
+  array.children = children_ptrs;
+
+  struct ArrowError error;
+  ASSERT_EQ(ArrowArrayByteSwap(&array, &schema, &error), NANOARROW_OK);
+
+  EXPECT_EQ(int32s[0], 1);
+  EXPECT_EQ(int32s[2], 3);
+  EXPECT_EQ(large_offsets[3], 6);
+  EXPECT_STREQ(large_data, "abcdef");
+  EXPECT_EQ(decimals[0], 1u);
+  EXPECT_EQ(decimals[1], 0u);
+  EXPECT_EQ(decimals[4], 3u);
+  for (int i = 0; i < 3; i++) {
+    int32_t months;
+    int32_t days;
+    int64_t nanoseconds;
+    memcpy(&months, month_day_nano + i * 16, sizeof(int32_t));
+    memcpy(&days, month_day_nano + i * 16 + 4, sizeof(int32_t));
+    memcpy(&nanoseconds, month_day_nano + i * 16 + 8, sizeof(int64_t));
+    EXPECT_EQ(months, 1);
+    EXPECT_EQ(days, 2);
+    EXPECT_EQ(nanoseconds, 3);
+  }
+  EXPECT_EQ(indices[1], 1);
+  EXPECT_EQ(dictionary_offsets[2], 6);
+  EXPECT_STREQ(dictionary_data, "onetwo");
+
+  // An array whose structure does not match the schema is left untouched
+  children[4].dictionary = nullptr;
+  EXPECT_EQ(ArrowArrayByteSwap(&array, &schema, &error), EINVAL);
+  EXPECT_STREQ(ArrowErrorMessage(&error), "Expected array dictionary to be non-NULL");
+  EXPECT_EQ(int32s[0], 1);
+
+  children[4].dictionary = &dictionary;
+  children[1].n_buffers = 2;
+  EXPECT_EQ(ArrowArrayByteSwap(&array, &schema, &error), EINVAL);
+  EXPECT_STREQ(ArrowErrorMessage(&error),
+               "Expected array with 3 buffer(s) but found 2 buffer(s)");
+
+  array.n_children = 4;
+  EXPECT_EQ(ArrowArrayByteSwap(&array, &schema, &error), EINVAL);
+  EXPECT_STREQ(ArrowErrorMessage(&error),
+               "Expected array with 5 child(ren) but found 4 child(ren)");
+  EXPECT_EQ(int32s[0], 1);
+
+  schema.release(&schema);
+}
+
+TEST(EndianTest, ArrayByteSwapMap) {
+  struct ArrowSchema schema;
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_MAP), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(&schema, 1), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[0], NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(schema.children[0], 2), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[0]->children[0], NANOARROW_TYPE_INT32),
+            NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[0]->children[1], NANOARROW_TYPE_INT16),
+            NANOARROW_OK);
+
+  // Two maps with one and two entries, written as if on a big-endian platform
+  int32_t offsets[] = {0, 0x01000000, 0x03000000};
+  int32_t keys[] = {0x01000000, 0x02000000, 0x03000000};
+  int16_t values[] = {0x0A00, 0x0B00, 0x0C00};
+
+  struct ArrowArray array;
+  ASSERT_EQ(ArrowArrayInit(&array, NANOARROW_TYPE_MAP), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppend(ArrowArrayBuffer(&array, 1), offsets, sizeof(offsets)),
+            NANOARROW_OK);
+  array.length = 2;
+
+  ASSERT_EQ(ArrowArrayAllocateChildren(&array, 1), NANOARROW_OK);
+  struct ArrowArray* entries = array.children[0];
+  ASSERT_EQ(ArrowArrayInit(entries, NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  entries->length = 3;
+
+  ASSERT_EQ(ArrowArrayAllocateChildren(entries, 2), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayInit(entries->children[0], NANOARROW_TYPE_INT32), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppend(ArrowArrayBuffer(entries->children[0], 1), keys,
+                              sizeof(keys)),
+            NANOARROW_OK);
+  entries->children[0]->length = 3;
+  ASSERT_EQ(ArrowArrayInit(entries->children[1], NANOARROW_TYPE_INT16), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppend(ArrowArrayBuffer(entries->children[1], 1), values,
+                              sizeof(values)),
+            NANOARROW_OK);
+  entries->children[1]->length = 3;
+
+  struct ArrowError error;
+  ASSERT_EQ(ArrowArrayFinishBuilding(&array, &error), NANOARROW_OK);
+  ASSERT_EQ(ArrowArrayByteSwap(&array, &schema, &error), NANOARROW_OK);
+
+  const int32_t* offsets_out = reinterpret_cast<const int32_t*>(array.buffers[1]);
+  EXPECT_EQ(offsets_out[0], 0);
+  EXPECT_EQ(offsets_out[1], 1);
+  EXPECT_EQ(offsets_out[2], 3);
+  const int32_t* keys_out =
+      reinterpret_cast<const int32_t*>(entries->children[0]->buffers[1]);
+  EXPECT_EQ(keys_out[2], 3);
+  const int16_t* values_out =
+      reinterpret_cast<const int16_t*>(entries->children[1]->buffers[1]);
+  EXPECT_EQ(values_out[0], 0x0A);
+  EXPECT_EQ(values_out[2], 0x0C);
+
+  array.release(&array);
+  schema.release(&schema);
+}
@@ -0,0 +1,385 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <string.h>
+
+#include "nanoarrow.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ArrowHash64() is the 64-bit variant of XXH3 (https://github.com/Cyan4973/xxHash)
+// with a seed. Inputs of up to 240 bytes are mixed 16 bytes at a time. Longer
+// inputs are consumed in 64-byte stripes by eight independent 64-bit lanes that
+// each need only a 32x32->64-bit multiply and an add per 8 bytes, which maps
+// onto SIMD instructions and keeps up with memory bandwidth. Input is read as
+// little-endian so that the result does not depend on the platform.
+
+#define NANOARROW_HASH_PRIME32_1 0x9E3779B1U
+#define NANOARROW_HASH_PRIME32_2 0x85EBCA77U
+#define NANOARROW_HASH_PRIME32_3 0xC2B2AE3DU
+#define NANOARROW_HASH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define NANOARROW_HASH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define NANOARROW_HASH_PRIME64_3 0x165667B19E3779F9ULL
+#define NANOARROW_HASH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define NANOARROW_HASH_PRIME64_5 0x27D4EB2F165667C5ULL
+#define NANOARROW_HASH_PRIME_MX1 0x165667919E3779F9ULL
+#define NANOARROW_HASH_PRIME_MX2 0x9FB21C651E98DF25ULL
+
+#define NANOARROW_HASH_SECRET_BYTES 192
+#define NANOARROW_HASH_STRIPE_BYTES 64
+#define NANOARROW_HASH_STRIPES_PER_BLOCK ((NANOARROW_HASH_SECRET_BYTES - 64) / 8)
+
+// The default XXH3 secret
+static const uint8_t kArrowHashSecret[NANOARROW_HASH_SECRET_BYTES] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21,
+    0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4,
+    0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a,
+    0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21, 0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e,
+    0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3,
+    0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97,
+    0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8, 0xa8, 0xfa,
+    0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78,
+    0x73, 0x64, 0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff,
+    0xfa, 0x13, 0x63, 0xeb, 0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16,
+    0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+    0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16,
+    0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e};
+
+static inline uint64_t ArrowHashRotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t ArrowHashRead64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(uint64_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  return value;
+}
+
+static inline uint32_t ArrowHashRead32(const uint8_t* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(uint32_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap32(value);
+#endif
+  return value;
+}
+
+static inline void ArrowHashWrite64(uint8_t* data, uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  memcpy(data, &value, sizeof(uint64_t));
+}
+
+static inline uint64_t ArrowHashSwap64(uint64_t value) {
+  return ((value & 0x00000000000000FFULL) << 56) |
+         ((value & 0x000000000000FF00ULL) << 40) |
+         ((value & 0x0000000000FF0000ULL) << 24) |
+         ((value & 0x00000000FF000000ULL) << 8) |
+         ((value & 0x000000FF00000000ULL) >> 8) |
+         ((value & 0x0000FF0000000000ULL) >> 24) |
+         ((value & 0x00FF000000000000ULL) >> 40) |
+         ((value & 0xFF00000000000000ULL) >> 56);
+}
+
+static inline uint32_t ArrowHashSwap32(uint32_t value) {
+  return ((value << 24) & 0xFF000000U) | ((value << 8) & 0x00FF0000U) |
+         ((value >> 8) & 0x0000FF00U) | ((value >> 24) & 0x000000FFU);
+}
+
+#if defined(__SIZEOF_INT128__)
+// __int128 is not ISO C; __extension__ keeps -Wpedantic builds warning-free
+__extension__ typedef unsigned __int128 ArrowHashUInt128;
+#endif
+
+// The XOR of the high and low halves of the 128-bit product of lhs and rhs
+static inline uint64_t ArrowHashMultiplyFold(uint64_t lhs, uint64_t rhs) {
+#if defined(__SIZEOF_INT128__)
+  ArrowHashUInt128 product = (ArrowHashUInt128)lhs * rhs;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+  uint64_t lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+  uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+  uint64_t lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+  uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+  uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+  uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+  return lower ^ upper;
+#endif
+}
+
+static inline uint64_t ArrowHashAvalancheXXH64(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= NANOARROW_HASH_PRIME64_2;
+  hash ^= hash >> 29;
+  hash *= NANOARROW_HASH_PRIME64_3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+static inline uint64_t ArrowHashAvalanche(uint64_t hash) {
+  hash ^= hash >> 37;
+  hash *= NANOARROW_HASH_PRIME_MX1;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+static inline uint64_t ArrowHashMix16(const uint8_t* data, const uint8_t* secret,
+                                      uint64_t seed) {
+  return ArrowHashMultiplyFold(ArrowHashRead64(data) ^ (ArrowHashRead64(secret) + seed),
+                               ArrowHashRead64(data + 8) ^
+                                   (ArrowHashRead64(secret + 8) - seed));
+}
+
+static uint64_t ArrowHashUpTo16(const uint8_t* data, uint64_t size_bytes,
+                                uint64_t seed) {
+  const uint8_t* secret = kArrowHashSecret;
+
+  if (size_bytes > 8) {
+    uint64_t bitflip1 =
+        (ArrowHashRead64(secret + 24) ^ ArrowHashRead64(secret + 32)) + seed;
+    uint64_t bitflip2 =
+        (ArrowHashRead64(secret + 40) ^ ArrowHashRead64(secret + 48)) - seed;
+    uint64_t lo = ArrowHashRead64(data) ^ bitflip1;
+    uint64_t hi = ArrowHashRead64(data + size_bytes - 8) ^ bitflip2;
+    uint64_t acc = size_bytes + ArrowHashSwap64(lo) + hi + ArrowHashMultiplyFold(lo, hi);
+    return ArrowHashAvalanche(acc);
+  } else if (size_bytes >= 4) {
+    seed ^= (uint64_t)ArrowHashSwap32((uint32_t)seed) << 32;
+    uint64_t bitflip =
+        (ArrowHashRead64(secret + 8) ^ ArrowHashRead64(secret + 16)) - seed;
+    uint64_t value = ArrowHashRead32(data + size_bytes - 4) +
+                     ((uint64_t)ArrowHashRead32(data) << 32);
+    uint64_t hash = value ^ bitflip;
+    hash ^= ArrowHashRotateLeft(hash, 49) ^ ArrowHashRotateLeft(hash, 24);
+    hash *= NANOARROW_HASH_PRIME_MX2;
+    hash ^= (hash >> 35) + size_bytes;
+    hash *= NANOARROW_HASH_PRIME_MX2;
+    return hash ^ (hash >> 28);
+  } else if (size_bytes > 0) {
+    uint32_t combined = ((uint32_t)data[0] << 16) |
+                        ((uint32_t)data[size_bytes >> 1] << 24) |
+                        (uint32_t)data[size_bytes - 1] | ((uint32_t)size_bytes << 8);
+    uint64_t bitflip = (ArrowHashRead32(secret) ^ ArrowHashRead32(secret + 4)) + seed;
+    return ArrowHashAvalancheXXH64((uint64_t)combined ^ bitflip);
+  } else {
+    return ArrowHashAvalancheXXH64(seed ^ (ArrowHashRead64(secret + 56) ^
+                                           ArrowHashRead64(secret + 64)));
+  }
+}
+
+static uint64_t ArrowHashUpTo128(const uint8_t* data, uint64_t size_bytes,
+                                 uint64_t seed) {
+  const uint8_t* secret = kArrowHashSecret;
+  uint64_t acc = size_bytes * NANOARROW_HASH_PRIME64_1;
+
+  if (size_bytes > 32) {
+    if (size_bytes > 64) {
+      if (size_bytes > 96) {
+        acc += ArrowHashMix16(data + 48, secret + 96, seed);
+        acc += ArrowHashMix16(data + size_bytes - 64, secret + 112, seed);
+      }
+      acc += ArrowHashMix16(data + 32, secret + 64, seed);
+      acc += ArrowHashMix16(data + size_bytes - 48, secret + 80, seed);
+    }
+    acc += ArrowHashMix16(data + 16, secret + 32, seed);
+    acc += ArrowHashMix16(data + size_bytes - 32, secret + 48, seed);
+  }
+
+  acc += ArrowHashMix16(data, secret, seed);
+  acc += ArrowHashMix16(data + size_bytes - 16, secret + 16, seed);
+  return ArrowHashAvalanche(acc);
+}
+
+static uint64_t ArrowHashUpTo240(const uint8_t* data, uint64_t size_bytes,
+                                 uint64_t seed) {
+  const uint8_t* secret = kArrowHashSecret;
+  uint64_t acc = size_bytes * NANOARROW_HASH_PRIME64_1;
+  int64_t n_rounds = (int64_t)size_bytes / 16;
+
+  for (int64_t i = 0; i < 8; i++) {
+    acc += ArrowHashMix16(data + 16 * i, secret + 16 * i, seed);
+  }
+
+  // The remaining rounds and the last 16 bytes use the secret at odd offsets so
+  // that they do not reuse the keys of the first eight rounds
+  acc = ArrowHashAvalanche(acc);
+  uint64_t acc_end = ArrowHashMix16(data + size_bytes - 16, secret + 136 - 17, seed);
+  for (int64_t i = 8; i < n_rounds; i++) {
+    acc_end += ArrowHashMix16(data + 16 * i, secret + 16 * (i - 8) + 3, seed);
+  }
+
+  return ArrowHashAvalanche(acc + acc_end);
+}
+
+// Accumulates n_stripes consecutive 64-byte stripes, advancing through the
+// secret by 8 bytes per stripe. Each 64-bit lane adds the product of the low
+// and high halves of (input ^ secret) to itself and the raw input to its
+// neighbour.
+static void ArrowHashAccumulate(uint64_t* acc, const uint8_t* data,
+                                const uint8_t* secret, int64_t n_stripes) {
+#if defined(__AVX2__)
+  __m256i acc_vec[2];
+  acc_vec[0] = _mm256_loadu_si256((const __m256i*)acc);
+  acc_vec[1] = _mm256_loadu_si256((const __m256i*)(acc + 4));
+  for (int64_t n = 0; n < n_stripes; n++) {
+    const uint8_t* stripe = data + n * NANOARROW_HASH_STRIPE_BYTES;
+    for (int i = 0; i < 2; i++) {
+      __m256i data_vec = _mm256_loadu_si256((const __m256i*)(stripe + 32 * i));
+      __m256i key_vec = _mm256_loadu_si256((const __m256i*)(secret + n * 8 + 32 * i));
+      __m256i data_key = _mm256_xor_si256(data_vec, key_vec);
+      __m256i data_key_hi = _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+      __m256i product = _mm256_mul_epu32(data_key, data_key_hi);
+      __m256i data_swap = _mm256_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+      acc_vec[i] = _mm256_add_epi64(acc_vec[i], _mm256_add_epi64(product, data_swap));
+    }
+  }
+  _mm256_storeu_si256((__m256i*)acc, acc_vec[0]);
+  _mm256_storeu_si256((__m256i*)(acc + 4), acc_vec[1]);
+#elif defined(__SSE2__)
+  __m128i acc_vec[4];
+  for (int i = 0; i < 4; i++) {
+    acc_vec[i] = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+  }
+  for (int64_t n = 0; n < n_stripes; n++) {
+    const uint8_t* stripe = data + n * NANOARROW_HASH_STRIPE_BYTES;
+    for (int i = 0; i < 4; i++) {
+      __m128i data_vec = _mm_loadu_si128((const __m128i*)(stripe + 16 * i));
+      __m128i key_vec = _mm_loadu_si128((const __m128i*)(secret + n * 8 + 16 * i));
+      __m128i data_key = _mm_xor_si128(data_vec, key_vec);
+      __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+      __m128i product = _mm_mul_epu32(data_key, data_key_hi);
+      __m128i data_swap = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+      acc_vec[i] = _mm_add_epi64(acc_vec[i], _mm_add_epi64(product, data_swap));
+    }
+  }
+  for (int i = 0; i < 4; i++) {
+    _mm_storeu_si128((__m128i*)(acc + 2 * i), acc_vec[i]);
+  }
+#else
+  for (int64_t n = 0; n < n_stripes; n++) {
+    const uint8_t* stripe = data + n * NANOARROW_HASH_STRIPE_BYTES;
+    for (int i = 0; i < 8; i++) {
+      uint64_t data_val = ArrowHashRead64(stripe + 8 * i);
+      uint64_t data_key = data_val ^ ArrowHashRead64(secret + n * 8 + 8 * i);
+      acc[i ^ 1] += data_val;
+      acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+  }
+#endif
+}
+
+// Mixes the high bits of each lane back into the low bits after every block
+static void ArrowHashScramble(uint64_t* acc, const uint8_t* secret) {
+  for (int i = 0; i < 8; i++) {
+    uint64_t value = acc[i];
+    value ^= value >> 47;
+    value ^= ArrowHashRead64(secret + 8 * i);
+    acc[i] = value * NANOARROW_HASH_PRIME32_1;
+  }
+}
+
+static uint64_t ArrowHashLong(const uint8_t* data, uint64_t size_bytes,
+                              const uint8_t* secret) {
+  uint64_t acc[8] = {NANOARROW_HASH_PRIME32_3, NANOARROW_HASH_PRIME64_1,
+                     NANOARROW_HASH_PRIME64_2, NANOARROW_HASH_PRIME64_3,
+                     NANOARROW_HASH_PRIME64_4, NANOARROW_HASH_PRIME32_2,
+                     NANOARROW_HASH_PRIME64_5, NANOARROW_HASH_PRIME32_1};
+
+  const int64_t block_bytes =
+      NANOARROW_HASH_STRIPE_BYTES * NANOARROW_HASH_STRIPES_PER_BLOCK;
+  int64_t n_blocks = (int64_t)(size_bytes - 1) / block_bytes;
+  for (int64_t n = 0; n < n_blocks; n++) {
+    ArrowHashAccumulate(acc, data + n * block_bytes, secret,
+                        NANOARROW_HASH_STRIPES_PER_BLOCK);
+    ArrowHashScramble(acc, secret + NANOARROW_HASH_SECRET_BYTES - 64);
+  }
+
+  // The partial last block and then the last (possibly overlapping) stripe, whose
+  // secret is offset so that it differs from the one used by the scramble
+  int64_t n_stripes =
+      ((int64_t)(size_bytes - 1) - n_blocks * block_bytes) / NANOARROW_HASH_STRIPE_BYTES;
+  ArrowHashAccumulate(acc, data + n_blocks * block_bytes, secret, n_stripes);
+  ArrowHashAccumulate(acc, data + size_bytes - NANOARROW_HASH_STRIPE_BYTES,
+                      secret + NANOARROW_HASH_SECRET_BYTES - 64 - 7, 1);
+
+  // Merge the lanes pairwise using yet another offset into the secret
+  uint64_t hash = size_bytes * NANOARROW_HASH_PRIME64_1;
+  for (int i = 0; i < 4; i++) {
+    const uint8_t* key = secret + 11 + 16 * i;
+    hash += ArrowHashMultiplyFold(acc[2 * i] ^ ArrowHashRead64(key),
+                                  acc[2 * i + 1] ^ ArrowHashRead64(key + 8));
+  }
+
+  return ArrowHashAvalanche(hash);
+}
+
+uint64_t ArrowHash64(const void* data, int64_t size_bytes, uint64_t seed) {
+  const uint8_t* bytes = (const uint8_t*)data;
+
+  if (size_bytes <= 16) {
+    return ArrowHashUpTo16(bytes, (uint64_t)size_bytes, seed);
+  } else if (size_bytes <= 128) {
+    return ArrowHashUpTo128(bytes, (uint64_t)size_bytes, seed);
+  } else if (size_bytes <= 240) {
+    return ArrowHashUpTo240(bytes, (uint64_t)size_bytes, seed);
+  }
+
+  if (seed == 0) {
+    return ArrowHashLong(bytes, (uint64_t)size_bytes, kArrowHashSecret);
+  }
+
+  // Long inputs with a seed use a secret derived from it
+  uint8_t secret[NANOARROW_HASH_SECRET_BYTES];
+  for (int i = 0; i < NANOARROW_HASH_SECRET_BYTES; i += 16) {
+    ArrowHashWrite64(secret + i, ArrowHashRead64(kArrowHashSecret + i) + seed);
+    ArrowHashWrite64(secret + i + 8, ArrowHashRead64(kArrowHashSecret + i + 8) - seed);
+  }
+
+  return ArrowHashLong(bytes, (uint64_t)size_bytes, secret);
+}
+
+uint64_t ArrowBufferHash(const struct ArrowBuffer* buffer, uint64_t seed) {
+  return ArrowHash64(buffer->data, buffer->size_bytes, seed);
+}
+
+char ArrowBufferViewEqual(struct ArrowBufferView lhs, struct ArrowBufferView rhs) {
+  if (lhs.size_bytes != rhs.size_bytes) {
+    return 0;
+  }
+
+  if (lhs.data == rhs.data || lhs.size_bytes == 0) {
+    return 1;
+  }
+
+  return memcmp(lhs.data, rhs.data, lhs.size_bytes) == 0;
+}
+
+char ArrowBufferEqual(const struct ArrowBuffer* lhs, const struct ArrowBuffer* rhs) {
+  struct ArrowBufferView lhs_view = {lhs->data, lhs->size_bytes};
+  struct ArrowBufferView rhs_view = {rhs->data, rhs->size_bytes};
+  return ArrowBufferViewEqual(lhs_view, rhs_view);
+}
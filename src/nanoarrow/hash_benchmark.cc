@@ -0,0 +1,81 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+// Sizes cover the short (up to 16 bytes), medium (up to 240 bytes), and long
+// paths of the hash, and buffers that fit in cache and buffers that don't
+static void HashSizes(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t size_bytes : {16, 128, 4096, 1 << 20, 1 << 28}) {
+    benchmark->Arg(size_bytes);
+  }
+}
+
+static std::vector<uint8_t> Bytes(int64_t size_bytes) {
+  std::vector<uint8_t> bytes(size_bytes);
+  for (int64_t i = 0; i < size_bytes; i++) {
+    bytes[i] = static_cast<uint8_t>(i * 7919);
+  }
+
+  return bytes;
+}
+
+static void BM_Hash64(benchmark::State& state) {
+  std::vector<uint8_t> bytes = Bytes(state.range(0));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ArrowHash64(bytes.data(), bytes.size(), 0));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Equal buffers are the worst case: every byte of both has to be compared.
+// Throughput counts the bytes of one buffer.
+static void BM_BufferViewEqual(benchmark::State& state) {
+  std::vector<uint8_t> lhs = Bytes(state.range(0));
+  std::vector<uint8_t> rhs = lhs;
+  struct ArrowBufferView lhs_view = {lhs.data(), state.range(0)};
+  struct ArrowBufferView rhs_view = {rhs.data(), state.range(0)};
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ArrowBufferViewEqual(lhs_view, rhs_view));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// memcmp() for comparison with ArrowBufferViewEqual()
+static void BM_Memcmp(benchmark::State& state) {
+  std::vector<uint8_t> lhs = Bytes(state.range(0));
+  std::vector<uint8_t> rhs = lhs;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(memcmp(lhs.data(), rhs.data(), lhs.size()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Hash64)->Apply(HashSizes);
+BENCHMARK(BM_BufferViewEqual)->Apply(HashSizes);
+BENCHMARK(BM_Memcmp)->Apply(HashSizes);
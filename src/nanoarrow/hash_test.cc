@@ -0,0 +1,111 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+TEST(HashTest, Hash64KnownValues) {
+  // Reference values from the XXH3 reference implementation
+  EXPECT_EQ(ArrowHash64("", 0, 0), 0x2D06800538D394C2ULL);
+  EXPECT_EQ(ArrowHash64(nullptr, 0, 0), 0x2D06800538D394C2ULL);
+  EXPECT_EQ(ArrowHash64("a", 1, 0), 0xE6C632B61E964E1FULL);
+  EXPECT_EQ(ArrowHash64("abc", 3, 0), 0x78AF5F94892F3950ULL);
+
+  std::string long_string = "Nobody inspects the spammish repetition";
+  EXPECT_EQ(ArrowHash64(long_string.data(), long_string.size(), 0),
+            0x6CB00603B5CC47E9ULL);
+
+  // Longer than one 1024-byte block, with and without a seed
+  std::vector<uint8_t> bytes(1000);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    bytes[i] = static_cast<uint8_t>(i);
+  }
+  EXPECT_EQ(ArrowHash64(bytes.data(), bytes.size(), 0), 0xD33DD80B46F60E50ULL);
+  EXPECT_EQ(ArrowHash64(bytes.data(), bytes.size(), 1), 0xABEBCE472D08BDF7ULL);
+}
+
+TEST(HashTest, Hash64) {
+  std::vector<uint8_t> data(1000);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+
+  // Every length through the short, medium and long (striped) paths gives a
+  // distinct hash that depends on the seed
+  std::set<uint64_t> hashes;
+  for (int64_t size_bytes = 0; size_bytes < 300; size_bytes++) {
+    hashes.insert(ArrowHash64(data.data(), size_bytes, 0));
+    hashes.insert(ArrowHash64(data.data(), size_bytes, 1));
+  }
+  EXPECT_EQ(hashes.size(), 600u);
+
+  // ...and changing any single byte changes the hash
+  uint64_t hash = ArrowHash64(data.data(), data.size(), 0);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] ^= 1;
+    EXPECT_NE(ArrowHash64(data.data(), data.size(), 0), hash);
+    data[i] ^= 1;
+  }
+
+  // The hash only depends on the contents, not on their alignment
+  std::vector<uint8_t> shifted(data.size() + 1);
+  memcpy(shifted.data() + 1, data.data(), data.size());
+  EXPECT_EQ(ArrowHash64(shifted.data() + 1, data.size(), 0), hash);
+}
+
+TEST(HashTest, BufferHashAndEqual) {
+  struct ArrowBuffer buffer;
+  struct ArrowBuffer other;
+  ArrowBufferInit(&buffer);
+  ArrowBufferInit(&other);
+
+  EXPECT_TRUE(ArrowBufferEqual(&buffer, &other));
+  EXPECT_EQ(ArrowBufferHash(&buffer, 0), ArrowHash64(nullptr, 0, 0));
+
+  ASSERT_EQ(ArrowBufferAppend(&buffer, "abcdef", 6), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppend(&other, "abcde", 5), NANOARROW_OK);
+  EXPECT_FALSE(ArrowBufferEqual(&buffer, &other));
+
+  // Spare capacity does not count
+  ASSERT_EQ(ArrowBufferReserve(&other, 1000), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferAppend(&other, "f", 1), NANOARROW_OK);
+  EXPECT_TRUE(ArrowBufferEqual(&buffer, &other));
+  EXPECT_TRUE(ArrowBufferEqual(&buffer, &buffer));
+  EXPECT_EQ(ArrowBufferHash(&buffer, 0), ArrowBufferHash(&other, 0));
+  EXPECT_EQ(ArrowBufferHash(&buffer, 0), ArrowHash64("abcdef", 6, 0));
+
+  other.data[5] = 'g';
+  EXPECT_FALSE(ArrowBufferEqual(&buffer, &other));
+  EXPECT_NE(ArrowBufferHash(&buffer, 0), ArrowBufferHash(&other, 0));
+
+  // Ranges are compared using views
+  struct ArrowBufferView lhs = {buffer.data + 1, 3};
+  struct ArrowBufferView rhs = {"bcd", 3};
+  EXPECT_TRUE(ArrowBufferViewEqual(lhs, rhs));
+  rhs.size_bytes = 2;
+  EXPECT_FALSE(ArrowBufferViewEqual(lhs, rhs));
+  EXPECT_TRUE(ArrowBufferViewEqual({nullptr, 0}, {"", 0}));
+
+  ArrowBufferReset(&buffer);
+  ArrowBufferReset(&other);
+}
@@ -16,8 +16,14 @@
 // under the License.
 
 #include "allocator.c"
+#include "array.c"
+#include "bitmap.c"
 #include "buffer.c"
+#include "encoding.c"
+#include "endian.c"
 #include "error.c"
+#include "hash.c"
 #include "metadata.c"
 #include "schema.c"
 #include "schema_view.c"
+#include "take.c"
@@ -21,6 +21,9 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+// For memcpy() in the inline typed appenders (this makes <string.h> part of
+// what every file including nanoarrow.h sees)
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -126,6 +129,32 @@ struct ArrowArrayStream {
 /// definitions and encourages clients to stack or statically allocate
 /// where convenient.
 
+/// \defgroup nanoarrow-errors Error handling primitives
+/// Functions generally return an errno-compatible error code; functions that
+/// need to communicate more verbose error information accept a pointer
+/// to an ArrowError. This can be stack or statically allocated. The
+/// content of the message is undefined unless an error code has been
+/// returned.
+
+/// \brief Error type containing a UTF-8 encoded message.
+struct ArrowError {
+  char message[1024];
+};
+
+/// \brief Return code for success.
+#define NANOARROW_OK 0
+
+/// \brief Represents an errno-compatible error code
+typedef int ArrowErrorCode;
+
+/// \brief Set the contents of an error using printf syntax
+ArrowErrorCode ArrowErrorSet(struct ArrowError* error, const char* fmt, ...);
+
+/// \brief Get the contents of an error
+const char* ArrowErrorMessage(struct ArrowError* error);
+
+/// }@
+
 /// \defgroup nanoarrow-malloc Memory management
 ///
 /// Non-buffer members of a struct ArrowSchema and struct ArrowArray
@@ -134,6 +163,8 @@ struct ArrowArrayStream {
 /// are allocated using an ArrowBufferAllocator.
 
 /// \brief Allocate like malloc()
+///
+/// Uses malloc() unless an allocator was set using ArrowMallocSetAllocator().
 void* ArrowMalloc(int64_t size);
 
 /// \brief Reallocate like realloc()
@@ -160,39 +191,225 @@ struct ArrowBufferAllocator {
 
   /// \brief Opaque data specific to the allocator
   void* private_data;
+
+  /// \brief Allocate a buffer filled with zeroes or return NULL if it cannot be
+  /// allocated
+  ///
+  /// Allocators that get zeroed memory for free (e.g., from calloc() or fresh
+  /// pages from the operating system) can implement this to avoid writing to the
+  /// memory twice. May be NULL, in which case callers allocate() and zero the
+  /// memory themselves. Memory from allocate_zeroed() is freed using free().
+  /// This member comes last so that the layout and positional initializers of
+  /// allocators written without it remain valid.
+  uint8_t* (*allocate_zeroed)(struct ArrowBufferAllocator* allocator, int64_t size);
 };
 
 /// \brief Return the default allocator
 ///
-/// The default allocator uses ArrowMalloc(), ArrowRealloc(), and
-/// ArrowFree().
+/// The default allocator uses malloc(), calloc(), realloc(), and free().
 struct ArrowBufferAllocator* ArrowBufferAllocatorDefault();
 
-/// }@
+/// \brief Create an allocator that can only free foreign memory
+///
+/// Returns an allocator for wrapping memory owned by something else (e.g.,
+/// a memory-mapped file or a C++ std::vector) in an ArrowBuffer without
+/// copying it. Freeing the buffer calls custom_free, which can access
+/// private_data through its allocator argument. The allocator cannot
+/// allocate; reallocating (e.g., when appending to the buffer) copies the
+/// contents into memory from the default allocator, calls custom_free on
+/// the original memory, and replaces the allocator with the default
+/// allocator. See also ArrowBufferInitWrap().
+struct ArrowBufferAllocator ArrowBufferDeallocator(
+    void (*custom_free)(struct ArrowBufferAllocator* allocator, uint8_t* ptr,
+                        int64_t size),
+    void* private_data);
+
+/// \brief Route ArrowMalloc(), ArrowRealloc(), and ArrowFree() through an allocator
+///
+/// Structural allocations made by nanoarrow (e.g., the format, name,
+/// metadata, and children of a struct ArrowSchema) use ArrowMalloc(),
+/// ArrowRealloc(), and ArrowFree(), which call malloc(), realloc(), and free()
+/// by default. After calling this function these allocations use allocator
+/// instead (e.g., an arena or the pool allocator), with each allocation
+/// carrying a 16-byte header that records its size. Pass NULL to restore the
+/// default. This is a process-wide setting that is not thread-safe: it must be
+/// set at startup before any memory has been allocated with ArrowMalloc() and
+/// allocator must outlive every allocation made through it. Memory allocated
+/// with one setting must not be reallocated or freed under another.
+void ArrowMallocSetAllocator(struct ArrowBufferAllocator* allocator);
+
+/// \brief Initialize an arena allocator
+///
+/// The arena allocator hands out memory from chunks of at least chunk_size
+/// bytes by bumping a pointer, which makes allocating many small buffers
+/// (e.g., all the buffers of a batch) cheap. Reallocating or freeing the most
+/// recent allocation happens in place; all other memory is only reclaimed by
+/// ArrowBufferAllocatorArenaReset() or ArrowBufferAllocatorArenaRelease().
+/// Returns EINVAL for chunk_size <= 0. The caller is responsible for calling
+/// ArrowBufferAllocatorArenaRelease() if NANOARROW_OK is returned.
+ArrowErrorCode ArrowBufferAllocatorArenaInit(struct ArrowBufferAllocator* allocator,
+                                             int64_t chunk_size);
+
+/// \brief Invalidate all memory handed out by an arena allocator
+///
+/// Rewinds the arena so that its memory can be reused for the next batch. One
+/// chunk is retained; all other chunks are returned to the system.
+void ArrowBufferAllocatorArenaReset(struct ArrowBufferAllocator* allocator);
 
-/// \defgroup nanoarrow-errors Error handling primitives
-/// Functions generally return an errno-compatible error code; functions that
-/// need to communicate more verbose error information accept a pointer
-/// to an ArrowError. This can be stack or statically allocated. The
-/// content of the message is undefined unless an error code has been
-/// returned.
+/// \brief Release all memory held by an arena allocator
+void ArrowBufferAllocatorArenaRelease(struct ArrowBufferAllocator* allocator);
 
-/// \brief Error type containing a UTF-8 encoded message.
-struct ArrowError {
-  char message[1024];
+/// \brief Cache usage recorded by a recycling allocator
+struct ArrowBufferAllocatorRecyclingStats {
+  /// \brief The number of requests served by reusing a cached buffer
+  ///
+  /// Reallocations that fit within the capacity of the existing buffer are
+  /// counted as neither hits nor misses.
+  int64_t n_hits;
+
+  /// \brief The number of requests that called the base allocator
+  int64_t n_misses;
+
+  /// \brief The number of bytes currently held for reuse
+  int64_t bytes_cached;
 };
 
-/// \brief Return code for success.
-#define NANOARROW_OK 0
+/// \brief Initialize an allocator that recycles freed buffers
+///
+/// Freed buffers are kept (up to max_cached_bytes in total) and reused for
+/// later allocations that fit instead of being returned to base. Buffers
+/// remember their real capacity, so a buffer that was given a bigger recycled
+/// block grows in place until it outgrows that block. Producers that build
+/// batches of a similar shape over and over can use this to reach a steady
+/// state where building a batch does not allocate at all. Each allocation
+/// carries a 16-byte header. The recycling allocator is not thread-safe. The
+/// caller is responsible for calling ArrowBufferAllocatorRecyclingRelease()
+/// if NANOARROW_OK is returned.
+ArrowErrorCode ArrowBufferAllocatorRecyclingInit(struct ArrowBufferAllocator* allocator,
+                                                 struct ArrowBufferAllocator* base,
+                                                 int64_t max_cached_bytes);
+
+/// \brief Get the hit and miss counts of a recycling allocator
+void ArrowBufferAllocatorRecyclingGetStats(
+    struct ArrowBufferAllocator* allocator,
+    struct ArrowBufferAllocatorRecyclingStats* stats_out);
+
+/// \brief Release a recycling allocator
+///
+/// Returns all cached buffers to the base allocator, which is not released.
+/// Buffers still using the recycling allocator must be reset first.
+void ArrowBufferAllocatorRecyclingRelease(struct ArrowBufferAllocator* allocator);
 
-/// \brief Represents an errno-compatible error code
-typedef int ArrowErrorCode;
+/// \brief Memory usage recorded by a statistics allocator
+struct ArrowBufferAllocatorStats {
+  /// \brief The number of bytes currently allocated
+  int64_t bytes_allocated;
 
-/// \brief Set the contents of an error using printf syntax
-ArrowErrorCode ArrowErrorSet(struct ArrowError* error, const char* fmt, ...);
+  /// \brief The maximum value bytes_allocated has reached
+  int64_t peak_bytes_allocated;
 
-/// \brief Get the contents of an error
-const char* ArrowErrorMessage(struct ArrowError* error);
+  /// \brief The number of successful allocations
+  ///
+  /// This includes reallocations of a NULL pointer.
+  int64_t n_allocations;
+
+  /// \brief The number of successful reallocations of a non-NULL pointer
+  int64_t n_reallocations;
+
+  /// \brief The number of frees
+  ///
+  /// This includes reallocations to a size of zero.
+  int64_t n_frees;
+
+  /// \brief The number of bytes copied by reallocations that moved a buffer
+  int64_t bytes_copied;
+};
+
+/// \brief Initialize an allocator that records statistics about another allocator
+///
+/// Forwards all calls to base and atomically records the number of bytes
+/// allocated along with the number of calls that passed through it. The
+/// statistics allocator is thread-safe if base is thread-safe. The caller is
+/// responsible for calling ArrowBufferAllocatorStatsRelease() if NANOARROW_OK
+/// is returned.
+ArrowErrorCode ArrowBufferAllocatorStatsInit(struct ArrowBufferAllocator* allocator,
+                                             struct ArrowBufferAllocator* base);
+
+/// \brief Take a snapshot of the statistics recorded by a statistics allocator
+void ArrowBufferAllocatorStatsGet(struct ArrowBufferAllocator* allocator,
+                                  struct ArrowBufferAllocatorStats* stats_out);
+
+/// \brief Release a statistics allocator
+///
+/// The base allocator is not released.
+void ArrowBufferAllocatorStatsRelease(struct ArrowBufferAllocator* allocator);
+
+/// \brief Initialize an allocator that enforces a memory budget
+///
+/// Forwards all calls to base while keeping the total number of bytes
+/// allocated through this allocator (across all buffers that use it) at or
+/// below hard_limit. Allocations and reallocations that would exceed
+/// hard_limit fail, which causes ArrowBufferReserve() and friends to return
+/// ENOMEM. When an allocation causes the total to rise above soft_limit,
+/// soft_limit_callback (if non-NULL) is called from the allocating thread with
+/// the new total; it is called again only after the total has dropped back to
+/// or below soft_limit. The limit allocator is thread-safe if base is
+/// thread-safe, and the hard limit holds when many threads allocate at once
+/// because bytes are reserved against it atomically before base is called.
+/// Returns EINVAL for negative limits. The caller is responsible for calling
+/// ArrowBufferAllocatorLimitRelease() if NANOARROW_OK is returned.
+ArrowErrorCode ArrowBufferAllocatorLimitInit(
+    struct ArrowBufferAllocator* allocator, struct ArrowBufferAllocator* base,
+    int64_t soft_limit, int64_t hard_limit,
+    void (*soft_limit_callback)(struct ArrowBufferAllocator* allocator,
+                                int64_t bytes_allocated, void* callback_data),
+    void* callback_data);
+
+/// \brief Return the number of bytes currently allocated through a limit allocator
+int64_t ArrowBufferAllocatorLimitBytesAllocated(struct ArrowBufferAllocator* allocator);
+
+/// \brief Release a limit allocator
+///
+/// The base allocator is not released.
+void ArrowBufferAllocatorLimitRelease(struct ArrowBufferAllocator* allocator);
+
+/// \brief Return an allocator that aligns and pads buffers to 64 bytes
+///
+/// Buffers allocated with this allocator start at a 64-byte aligned address
+/// and their allocation is padded to a multiple of 64 bytes as recommended by
+/// the Arrow columnar format. A buffer with capacity_bytes of n may therefore
+/// be read using full-width aligned vector loads up to the next multiple of
+/// 64 bytes after n. Unlike the default allocator, growing a buffer beyond its
+/// padding always copies. This allocator is thread-safe.
+struct ArrowBufferAllocator* ArrowBufferAllocatorAligned();
+
+/// \brief Return an allocator that maps large buffers from the operating system
+///
+/// Buffers of at least NANOARROW_MMAP_THRESHOLD_BYTES (2 MiB by default) are
+/// backed by anonymous memory maps that opt in to transparent huge pages where
+/// supported. On Linux these grow using mremap(), which remaps pages instead of
+/// copying the buffer's contents. Smaller buffers use malloc(). This
+/// allocator is thread-safe. On platforms without mmap() this returns
+/// ArrowBufferAllocatorDefault().
+struct ArrowBufferAllocator* ArrowBufferAllocatorMmap();
+
+/// \brief Return the process-wide pool allocator
+///
+/// The pool allocator rounds allocations of up to 1 MiB up to a power-of-two
+/// size class and recycles freed blocks through per-thread caches, which avoids
+/// contention in the system allocator when many threads build buffers at once.
+/// Each thread caches a bounded number of bytes (see
+/// NANOARROW_POOL_THREAD_CACHE_BYTES); the surplus is returned to a global
+/// pool shared by all threads. Larger allocations use malloc() directly.
+/// This allocator is thread-safe. On platforms without POSIX threads this
+/// returns ArrowBufferAllocatorDefault().
+struct ArrowBufferAllocator* ArrowBufferAllocatorPool();
+
+/// \brief Return memory cached by the pool allocator to the system
+///
+/// Releases the calling thread's cache and the global pool. Caches held by
+/// other threads are released when those threads exit.
+void ArrowBufferAllocatorPoolTrim();
 
 /// }@
 
@@ -211,6 +428,17 @@ struct ArrowStringView {
   int64_t n_bytes;
 };
 
+/// \brief A non-owning view of a buffer
+struct ArrowBufferView {
+  /// \brief A pointer to the start of the buffer
+  ///
+  /// If size_bytes is 0, this value may be NULL.
+  const void* data;
+
+  /// \brief The size of the buffer in bytes
+  int64_t size_bytes;
+};
+
 /// \brief Arrow type enumerator
 ///
 /// These names are intended to map to the corresponding arrow::Type::type
@@ -313,6 +541,18 @@ ArrowErrorCode ArrowSchemaInitDateTime(struct ArrowSchema* schema,
 ArrowErrorCode ArrowSchemaDeepCopy(struct ArrowSchema* schema,
                                    struct ArrowSchema* schema_out);
 
+/// \brief Make a (recursive) copy of a schema in a single allocation
+///
+/// Like ArrowSchemaDeepCopy() but places the children arrays, child
+/// structs, dictionaries, and strings of the entire tree in one
+/// allocation that is freed when the last node is released. Children
+/// may be moved out of the copy and released independently. The
+/// result must not be modified using ArrowSchemaSetFormat(),
+/// ArrowSchemaSetName(), ArrowSchemaSetMetadata(),
+/// ArrowSchemaAllocateChildren(), or ArrowSchemaAllocateDictionary().
+ArrowErrorCode ArrowSchemaDeepCopyCompact(struct ArrowSchema* schema,
+                                          struct ArrowSchema* schema_out);
+
 /// \brief Copy format into schema->format
 ///
 /// schema must have been allocated using ArrowSchemaInit or
@@ -333,7 +573,8 @@ ArrowErrorCode ArrowSchemaSetMetadata(struct ArrowSchema* schema, const char* me
 
 /// \brief Allocate the schema->children array
 ///
-/// Includes the memory for each child struct ArrowSchema.
+/// Includes the memory for each child struct ArrowSchema, which is
+/// allocated in the same block as the array of pointers.
 /// schema must have been allocated using ArrowSchemaInit or
 /// ArrowSchemaDeepCopy.
 ArrowErrorCode ArrowSchemaAllocateChildren(struct ArrowSchema* schema,
@@ -485,6 +726,42 @@ ArrowErrorCode ArrowSchemaViewInit(struct ArrowSchemaView* schema_view,
 
 /// \defgroup nanoarrow-buffer-builder Growable buffer builders
 
+/// \brief How a buffer grows its capacity when it runs out of space
+///
+/// When a buffer needs more capacity than it has, its new capacity is its
+/// current capacity multiplied by growth_factor or, once the current capacity
+/// is at least linear_threshold_bytes, its current capacity plus
+/// linear_increment_bytes. The result is raised to min_capacity_bytes and to
+/// the capacity that was actually requested, then rounded up to a multiple of
+/// alignment_bytes. Rounding to the page size (e.g., 4096) or to the huge page
+/// size (e.g., 2 MiB) keeps large buffers from wasting a partial page.
+struct ArrowBufferGrowthPolicy {
+  /// \brief The factor by which capacity grows (e.g., 2 or 1.5)
+  ///
+  /// Must be at least 1. A factor of 1 grows to exactly the requested capacity.
+  double growth_factor;
+
+  /// \brief The minimum capacity of a buffer once it has been allocated
+  int64_t min_capacity_bytes;
+
+  /// \brief Round capacities up to a multiple of this value if it is greater than 1
+  int64_t alignment_bytes;
+
+  /// \brief Grow linearly instead of by growth_factor from this capacity on
+  ///
+  /// Use 0 to never grow linearly.
+  int64_t linear_threshold_bytes;
+
+  /// \brief The capacity added each time a buffer grows linearly
+  int64_t linear_increment_bytes;
+};
+
+/// \brief Initialize a growth policy with the default strategy
+///
+/// The default growth policy doubles a buffer's capacity and has no minimum
+/// capacity, alignment, or linear threshold.
+void ArrowBufferGrowthPolicyInit(struct ArrowBufferGrowthPolicy* policy);
+
 /// \brief An owning mutable view of a buffer
 struct ArrowBuffer {
   /// \brief A pointer to the start of the buffer
@@ -499,7 +776,16 @@ struct ArrowBuffer {
   int64_t capacity_bytes;
 
   /// \brief The allocator that will be used to reallocate and/or free the buffer
-  struct ArrowBufferAllocator* allocator;
+  ///
+  /// The allocator is held by value so that allocators created for a single
+  /// buffer (e.g., using ArrowBufferDeallocator()) do not need to be managed
+  /// separately.
+  struct ArrowBufferAllocator allocator;
+
+  /// \brief The growth policy used when the buffer is reserved or appended to
+  ///
+  /// If NULL, the buffer's capacity doubles each time it grows.
+  const struct ArrowBufferGrowthPolicy* growth_policy;
 };
 
 /// \brief Initialize an ArrowBuffer
@@ -508,12 +794,31 @@ struct ArrowBuffer {
 /// buffer allocator.
 void ArrowBufferInit(struct ArrowBuffer* buffer);
 
+/// \brief Initialize an ArrowBuffer that wraps existing memory
+///
+/// Initializes buffer with data as its contents and size_bytes as its size
+/// and capacity without copying. When the buffer is reset (or grown),
+/// deallocator is used to release data; deallocator is typically created
+/// using ArrowBufferDeallocator().
+void ArrowBufferInitWrap(struct ArrowBuffer* buffer, uint8_t* data, int64_t size_bytes,
+                         struct ArrowBufferAllocator* deallocator);
+
 /// \brief Set a newly-initialized buffer's allocator
 ///
-/// Returns EINVAL if the buffer has already been allocated.
+/// Copies allocator into the buffer. Returns EINVAL if the buffer has
+/// already been allocated.
 ArrowErrorCode ArrowBufferSetAllocator(struct ArrowBuffer* buffer,
                                        struct ArrowBufferAllocator* allocator);
 
+/// \brief Set a buffer's growth policy
+///
+/// The policy is not copied and must outlive the buffer; a policy shared by many
+/// buffers is typically static. Pass NULL to restore the default doubling
+/// strategy. Returns EINVAL if the policy is invalid (e.g., growth_factor is less
+/// than 1 or linear growth is enabled with an increment that is not positive).
+ArrowErrorCode ArrowBufferSetGrowthPolicy(struct ArrowBuffer* buffer,
+                                          const struct ArrowBufferGrowthPolicy* policy);
+
 /// \brief Reset an ArrowBuffer
 ///
 /// Releases the buffer using the allocator's free method if
@@ -533,13 +838,16 @@ void ArrowBufferMove(struct ArrowBuffer* buffer, struct ArrowBuffer* buffer_out)
 /// if shrink_to_fit is non-zero. Calling ArrowBufferResize() does not
 /// adjust the buffer's size member except to ensure that the invariant
 /// capacity >= size remains true.
+/// Returns ENOMEM and leaves the buffer unchanged if the allocator
+/// fails to reallocate the buffer.
 ArrowErrorCode ArrowBufferResize(struct ArrowBuffer* buffer, int64_t new_capacity_bytes,
                                  char shrink_to_fit);
 
 /// \brief Ensure a buffer has at least a given additional capacity
 ///
 /// Ensures that the buffer has space to append at least
-/// additional_size_bytes, overallocating when required.
+/// additional_size_bytes, overallocating according to the buffer's growth
+/// policy when required.
 ArrowErrorCode ArrowBufferReserve(struct ArrowBuffer* buffer,
                                   int64_t additional_size_bytes);
 
@@ -557,6 +865,761 @@ void ArrowBufferAppendUnsafe(struct ArrowBuffer* buffer, const void* data,
 ArrowErrorCode ArrowBufferAppend(struct ArrowBuffer* buffer, const void* data,
                                  int64_t size_bytes);
 
+/// \brief Append zeroes to buffer and increment the buffer size
+///
+/// Like ArrowBufferAppend() but writes size_bytes zero bytes. When the buffer
+/// has not been allocated yet and its allocator provides allocate_zeroed(), the
+/// zeroes come from the allocator (e.g., calloc()) and the memory is not written
+/// to at all, which makes building large all-valid bitmaps or zero-filled offset
+/// buffers cheap.
+ArrowErrorCode ArrowBufferAppendZeros(struct ArrowBuffer* buffer, int64_t size_bytes);
+
+/// \brief Write data to buffer without evicting other data from the cache
+///
+/// Like ArrowBufferAppendUnsafe() but, for appends of at least 1 MiB (or
+/// NANOARROW_NON_TEMPORAL_THRESHOLD_BYTES if defined when compiling nanoarrow),
+/// copies using non-temporal stores where the platform supports them (i.e.,
+/// x86 with SSE2). Copying a large page from disk this way leaves the caller's
+/// working set in the CPU caches instead of filling them with data that will
+/// not be read again soon. The stores are fenced before this function returns.
+/// This function does not check that buffer has the required capacity.
+///
+/// Whether a copy should bypass the cache depends on whether the caller is
+/// about to read the data, not on the buffer: the same buffer may receive
+/// large page copies that are not read again soon and small appends that are.
+/// This is therefore chosen per call rather than stored with the buffer like
+/// its growth policy.
+void ArrowBufferAppendNonTemporalUnsafe(struct ArrowBuffer* buffer, const void* data,
+                                        int64_t size_bytes);
+
+/// \brief Write data to buffer without evicting other data from the cache
+///
+/// Like ArrowBufferAppendNonTemporalUnsafe() but ensures that the buffer has the
+/// required capacity, possibly by reallocating the buffer.
+ArrowErrorCode ArrowBufferAppendNonTemporal(struct ArrowBuffer* buffer, const void* data,
+                                            int64_t size_bytes);
+
+/// \brief Append many buffers to a buffer
+///
+/// Appends the contents of n_views views to buffer after reserving the space
+/// for all of them at once, which allocates at most once no matter how many
+/// small buffers are being coalesced. Returns EINVAL without changing buffer
+/// if a view has a negative size or the sizes add up to more than INT64_MAX.
+ArrowErrorCode ArrowBufferConcatenate(struct ArrowBuffer* buffer,
+                                      const struct ArrowBufferView* views,
+                                      int64_t n_views);
+
+/// \brief Append many 32-bit offset buffers to an offset buffer
+///
+/// Each view is the int32_t offsets buffer of a string, binary, or list array
+/// (i.e., one more offset than the array's length). The offsets of each view
+/// are rebased so that they continue from the last offset in buffer, or from
+/// zero if buffer is empty, in the same pass that copies them; the data (or
+/// child) ranges that have to be concatenated alongside are given by the first
+/// and last offset of each view. Space for all offsets is reserved at once.
+/// Returns EOVERFLOW if the rebased offsets do not fit in 32 bits or EINVAL if
+/// a view's first offset is negative or its offsets ever decrease, leaving the
+/// contents of buffer unchanged in either case.
+ArrowErrorCode ArrowBufferConcatenateInt32Offsets(struct ArrowBuffer* buffer,
+                                                  const struct ArrowBufferView* views,
+                                                  int64_t n_views);
+
+/// \brief Append many 64-bit offset buffers to an offset buffer
+///
+/// Like ArrowBufferConcatenateInt32Offsets() for the int64_t offsets of large
+/// string, large binary, and large list arrays.
+ArrowErrorCode ArrowBufferConcatenateInt64Offsets(struct ArrowBuffer* buffer,
+                                                  const struct ArrowBufferView* views,
+                                                  int64_t n_views);
+
+// The typed appenders are defined inline so that appending a single value to a
+// buffer with enough capacity compiles to a store and an add rather than a call
+// into buffer.c and a variable-length memcpy(). The memcpy() of a fixed,
+// small size is how a possibly unaligned store is spelled portably.
+
+/// \brief Write an int8_t to buffer without checking its capacity
+static inline void ArrowBufferAppendInt8Unsafe(struct ArrowBuffer* buffer, int8_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(int8_t));
+  buffer->size_bytes += sizeof(int8_t);
+}
+
+/// \brief Write an int8_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendInt8(struct ArrowBuffer* buffer,
+                                                   int8_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(int8_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(int8_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendInt8Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write a uint8_t to buffer without checking its capacity
+static inline void ArrowBufferAppendUInt8Unsafe(struct ArrowBuffer* buffer,
+                                                uint8_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(uint8_t));
+  buffer->size_bytes += sizeof(uint8_t);
+}
+
+/// \brief Write a uint8_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendUInt8(struct ArrowBuffer* buffer,
+                                                    uint8_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(uint8_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(uint8_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendUInt8Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write an int16_t to buffer without checking its capacity
+static inline void ArrowBufferAppendInt16Unsafe(struct ArrowBuffer* buffer,
+                                                int16_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(int16_t));
+  buffer->size_bytes += sizeof(int16_t);
+}
+
+/// \brief Write an int16_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendInt16(struct ArrowBuffer* buffer,
+                                                    int16_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(int16_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(int16_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendInt16Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write a uint16_t to buffer without checking its capacity
+static inline void ArrowBufferAppendUInt16Unsafe(struct ArrowBuffer* buffer,
+                                                 uint16_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(uint16_t));
+  buffer->size_bytes += sizeof(uint16_t);
+}
+
+/// \brief Write a uint16_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendUInt16(struct ArrowBuffer* buffer,
+                                                     uint16_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(uint16_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(uint16_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendUInt16Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write an int32_t to buffer without checking its capacity
+static inline void ArrowBufferAppendInt32Unsafe(struct ArrowBuffer* buffer,
+                                                int32_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(int32_t));
+  buffer->size_bytes += sizeof(int32_t);
+}
+
+/// \brief Write an int32_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendInt32(struct ArrowBuffer* buffer,
+                                                    int32_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(int32_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(int32_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendInt32Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write a uint32_t to buffer without checking its capacity
+static inline void ArrowBufferAppendUInt32Unsafe(struct ArrowBuffer* buffer,
+                                                 uint32_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(uint32_t));
+  buffer->size_bytes += sizeof(uint32_t);
+}
+
+/// \brief Write a uint32_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendUInt32(struct ArrowBuffer* buffer,
+                                                     uint32_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(uint32_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(uint32_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendUInt32Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write an int64_t to buffer without checking its capacity
+static inline void ArrowBufferAppendInt64Unsafe(struct ArrowBuffer* buffer,
+                                                int64_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(int64_t));
+  buffer->size_bytes += sizeof(int64_t);
+}
+
+/// \brief Write an int64_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendInt64(struct ArrowBuffer* buffer,
+                                                    int64_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(int64_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(int64_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendInt64Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write a uint64_t to buffer without checking its capacity
+static inline void ArrowBufferAppendUInt64Unsafe(struct ArrowBuffer* buffer,
+                                                 uint64_t value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(uint64_t));
+  buffer->size_bytes += sizeof(uint64_t);
+}
+
+/// \brief Write a uint64_t to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendUInt64(struct ArrowBuffer* buffer,
+                                                     uint64_t value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(uint64_t)) {
+    int result = ArrowBufferReserve(buffer, sizeof(uint64_t));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendUInt64Unsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write a float to buffer without checking its capacity
+static inline void ArrowBufferAppendFloatUnsafe(struct ArrowBuffer* buffer, float value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(float));
+  buffer->size_bytes += sizeof(float);
+}
+
+/// \brief Write a float to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendFloat(struct ArrowBuffer* buffer,
+                                                    float value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(float)) {
+    int result = ArrowBufferReserve(buffer, sizeof(float));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendFloatUnsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief Write a double to buffer without checking its capacity
+static inline void ArrowBufferAppendDoubleUnsafe(struct ArrowBuffer* buffer,
+                                                 double value) {
+  memcpy(buffer->data + buffer->size_bytes, &value, sizeof(double));
+  buffer->size_bytes += sizeof(double);
+}
+
+/// \brief Write a double to buffer, reserving space if required
+static inline ArrowErrorCode ArrowBufferAppendDouble(struct ArrowBuffer* buffer,
+                                                     double value) {
+  if ((buffer->capacity_bytes - buffer->size_bytes) < (int64_t)sizeof(double)) {
+    int result = ArrowBufferReserve(buffer, sizeof(double));
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBufferAppendDoubleUnsafe(buffer, value);
+  return NANOARROW_OK;
+}
+
+/// \brief A builder for the offsets and data buffers of a string or binary array
+///
+/// Keeps the offsets buffer and the data buffer of a string, binary,
+/// large_string, or large_binary array in sync. Offsets are 32-bit for string
+/// and binary types and 64-bit for their large counterparts. Once anything has
+/// been reserved or appended, the offsets buffer contains length + 1 offsets.
+struct ArrowStringBuilder {
+  /// \brief The offsets buffer
+  struct ArrowBuffer offsets;
+
+  /// \brief The data buffer
+  struct ArrowBuffer data;
+
+  /// \brief The number of values that have been appended
+  int64_t length;
+
+  /// \brief The type of array being built
+  ///
+  /// One of NANOARROW_TYPE_STRING, NANOARROW_TYPE_BINARY,
+  /// NANOARROW_TYPE_LARGE_STRING, or NANOARROW_TYPE_LARGE_BINARY. This changes
+  /// to the corresponding large type if the offsets are promoted.
+  enum ArrowType type;
+
+  /// \brief Non-zero if 32-bit offsets are promoted to 64-bit offsets on overflow
+  char promote_offsets;
+};
+
+/// \brief Initialize an ArrowStringBuilder
+///
+/// Initializes the builder's buffers using the default allocator without
+/// allocating them, so that their allocators or growth policies can still be
+/// changed. type must be one of NANOARROW_TYPE_STRING,
+/// NANOARROW_TYPE_BINARY, NANOARROW_TYPE_LARGE_STRING, or
+/// NANOARROW_TYPE_LARGE_BINARY (or EINVAL is returned). If promote_offsets is
+/// non-zero, appending more data than 32-bit offsets can address converts the
+/// offsets to 64-bit and changes type to the corresponding large type; otherwise,
+/// such an append returns EOVERFLOW so that the caller can finish the current
+/// batch and start a new one.
+ArrowErrorCode ArrowStringBuilderInit(struct ArrowStringBuilder* builder,
+                                      enum ArrowType type, char promote_offsets);
+
+/// \brief Ensure an ArrowStringBuilder has space for additional values
+///
+/// Reserves space for additional_length more offsets and additional_size_bytes
+/// more bytes of data and writes the first offset if it has not been written yet
+/// (e.g., to finish a builder to which nothing was appended).
+ArrowErrorCode ArrowStringBuilderReserve(struct ArrowStringBuilder* builder,
+                                         int64_t additional_length,
+                                         int64_t additional_size_bytes);
+
+/// \brief Append a value to an ArrowStringBuilder
+///
+/// Returns EOVERFLOW and leaves the builder unchanged if the value does not fit
+/// in 32-bit offsets and the builder does not promote its offsets.
+ArrowErrorCode ArrowStringBuilderAppend(struct ArrowStringBuilder* builder,
+                                        struct ArrowStringView value);
+
+/// \brief Append many values to an ArrowStringBuilder
+///
+/// Computes the offsets of all values with a single prefix sum and reserves the
+/// offsets and data buffers once. Either all values are appended or none are:
+/// returns EOVERFLOW if the values do not fit in 32-bit offsets and the builder
+/// does not promote its offsets, EINVAL if a value has a negative size, or
+/// ENOMEM if the buffers cannot grow, leaving the builder unchanged (and its
+/// offsets unpromoted) in every case.
+ArrowErrorCode ArrowStringBuilderAppendBulk(struct ArrowStringBuilder* builder,
+                                            const struct ArrowStringView* values,
+                                            int64_t n_values);
+
+/// \brief Reset an ArrowStringBuilder
+///
+/// Releases the builder's buffers and sets its length to zero.
+void ArrowStringBuilderReset(struct ArrowStringBuilder* builder);
+
+/// \brief A reference-counted buffer
+///
+/// An ArrowSharedBuffer owns the memory of an ArrowBuffer and hands out
+/// ArrowBuffers that are zero-copy slices of it, each of which holds a reference.
+/// The memory is freed when the shared buffer and every slice have been
+/// released, in any order and from any thread. This lets many arrays (e.g.,
+/// several exported arrays that share one dictionary) point at the same bytes.
+struct ArrowSharedBuffer;
+
+/// \brief Create an ArrowSharedBuffer from an ArrowBuffer
+///
+/// Moves buffer into a new shared buffer with a single reference (held by the
+/// caller) and resets buffer. Returns ENOMEM and leaves buffer untouched if the
+/// shared buffer could not be allocated.
+ArrowErrorCode ArrowSharedBufferInit(struct ArrowSharedBuffer** shared_buffer_out,
+                                     struct ArrowBuffer* buffer);
+
+/// \brief Return the shared buffer's data
+const uint8_t* ArrowSharedBufferData(struct ArrowSharedBuffer* shared_buffer);
+
+/// \brief Return the size of the shared buffer in bytes
+int64_t ArrowSharedBufferSizeBytes(struct ArrowSharedBuffer* shared_buffer);
+
+/// \brief Create an ArrowBuffer that is a slice of a shared buffer
+///
+/// Initializes buffer_out to refer to size_bytes bytes of shared_buffer starting
+/// at offset without copying and adds a reference to shared_buffer that is
+/// released when buffer_out is reset. Writing to the slice writes to the shared
+/// memory; growing the slice copies it into memory of its own first. Returns
+/// EINVAL if the slice is out of bounds.
+ArrowErrorCode ArrowSharedBufferSlice(struct ArrowSharedBuffer* shared_buffer,
+                                      int64_t offset, int64_t size_bytes,
+                                      struct ArrowBuffer* buffer_out);
+
+/// \brief Release a reference to a shared buffer
+///
+/// Releases the reference returned by ArrowSharedBufferInit(). The memory is
+/// freed once all slices have been reset as well.
+void ArrowSharedBufferRelease(struct ArrowSharedBuffer* shared_buffer);
+
+/// }@
+
+/// \defgroup nanoarrow-bitmap Bitmap utilities
+///
+/// Bitmaps (e.g., validity buffers and the values of boolean arrays) pack one
+/// value per bit, least significant bit first.
+
+/// \brief Return the number of bytes required to hold n_bits bits
+static inline int64_t ArrowBytesForBits(int64_t n_bits) {
+  return (n_bits >> 3) + ((n_bits & 7) != 0);
+}
+
+/// \brief Return non-zero if bit i of bits is set
+static inline int8_t ArrowBitGet(const uint8_t* bits, int64_t i) {
+  return (bits[i >> 3] >> (i & 7)) & 1;
+}
+
+/// \brief Set bit i of bits
+static inline void ArrowBitSet(uint8_t* bits, int64_t i) {
+  bits[i >> 3] |= (uint8_t)(1 << (i & 7));
+}
+
+/// \brief Clear bit i of bits
+static inline void ArrowBitClear(uint8_t* bits, int64_t i) {
+  bits[i >> 3] &= (uint8_t)~(1 << (i & 7));
+}
+
+/// \brief Set bit i of bits if bit_is_set is non-zero or clear it otherwise
+static inline void ArrowBitSetTo(uint8_t* bits, int64_t i, uint8_t bit_is_set) {
+  if (bit_is_set) {
+    ArrowBitSet(bits, i);
+  } else {
+    ArrowBitClear(bits, i);
+  }
+}
+
+/// \brief Count the set bits in a range of a bitmap
+///
+/// Counts the bits of bits that are set, starting at bit i_from (which need not
+/// be a multiple of 8) and continuing for length bits. The null count of a
+/// validity bitmap is length minus this value. Whole 64-bit words are counted
+/// with a population count instruction where available (and 64 bytes at a time
+/// when compiled with AVX-512 VPOPCNTDQ or 32 bytes at a time with AVX2). x86
+/// builds that do not target AVX2 check at run time whether the CPU supports
+/// AVX2 or POPCNT.
+int64_t ArrowBitCountSet(const uint8_t* bits, int64_t i_from, int64_t length);
+
+/// \brief Pack a byte-per-value array into a range of a bitmap
+///
+/// Sets bit i_from + i of bits if values[i] is non-zero and clears it otherwise
+/// for i in [0, length). i_from need not be a multiple of 8; bits outside the
+/// range are left untouched.
+void ArrowBitsPackInt8(uint8_t* bits, int64_t i_from, int64_t length,
+                       const int8_t* values);
+
+/// \brief Unpack a range of a bitmap into a byte-per-value array
+///
+/// Writes 1 to out[i] if bit i_from + i of bits is set and 0 otherwise for i in
+/// [0, length). i_from need not be a multiple of 8.
+void ArrowBitsUnpackInt8(const uint8_t* bits, int64_t i_from, int64_t length,
+                         int8_t* out);
+
+/// \brief A growable bitmap
+///
+/// An ArrowBitmap builds a bitmap on top of an ArrowBuffer, keeping track of
+/// its size in bits and of how many of the appended bits were not set so that
+/// the null count of a validity buffer is known as soon as it is built. Bits
+/// between size_bits and the end of the buffer's capacity are always zero.
+struct ArrowBitmap {
+  /// \brief An ArrowBuffer to hold the allocated memory
+  ///
+  /// The buffer's size_bytes is kept in sync with size_bits.
+  struct ArrowBuffer buffer;
+
+  /// \brief The number of bits that have been appended to the bitmap
+  int64_t size_bits;
+
+  /// \brief The number of appended bits that were not set
+  int64_t null_count;
+};
+
+/// \brief Initialize an ArrowBitmap
+///
+/// Initializes the bitmap's buffer using the default allocator and sets its size
+/// and null count to zero.
+void ArrowBitmapInit(struct ArrowBitmap* bitmap);
+
+/// \brief Ensure a bitmap has at least a given additional capacity
+///
+/// Ensures that the bitmap has space to append at least
+/// additional_size_bits, overallocating when required.
+ArrowErrorCode ArrowBitmapReserve(struct ArrowBitmap* bitmap,
+                                  int64_t additional_size_bits);
+
+/// \brief Append length identical bits to a bitmap without checking its capacity
+void ArrowBitmapAppendUnsafe(struct ArrowBitmap* bitmap, uint8_t bits_are_set,
+                             int64_t length);
+
+/// \brief Append length identical bits to a bitmap
+///
+/// Sets length bits if bits_are_set is non-zero or appends length unset bits
+/// otherwise, reserving space if required.
+ArrowErrorCode ArrowBitmapAppend(struct ArrowBitmap* bitmap, uint8_t bits_are_set,
+                                 int64_t length);
+
+/// \brief Append one bit per value of a byte-per-value array without checking
+/// the bitmap's capacity
+///
+/// Each non-zero value appends a set bit and each zero value an unset bit.
+void ArrowBitmapAppendInt8Unsafe(struct ArrowBitmap* bitmap, const int8_t* values,
+                                 int64_t n_values);
+
+/// \brief Append one bit per value of a byte-per-value array
+ArrowErrorCode ArrowBitmapAppendInt8(struct ArrowBitmap* bitmap, const int8_t* values,
+                                     int64_t n_values);
+
+/// \brief Reset a bitmap builder
+///
+/// Releases any memory held by the bitmap's buffer and resets its size and
+/// null count to zero.
+void ArrowBitmapReset(struct ArrowBitmap* bitmap);
+
+/// \brief Append a single bit to a bitmap without checking its capacity
+static inline void ArrowBitmapAppendBitUnsafe(struct ArrowBitmap* bitmap,
+                                              uint8_t bit_is_set) {
+  // Bits past the end of the bitmap are zero, so only set bits need a write
+  if (bit_is_set) {
+    ArrowBitSet(bitmap->buffer.data, bitmap->size_bits);
+  } else {
+    bitmap->null_count++;
+  }
+
+  bitmap->size_bits++;
+  bitmap->buffer.size_bytes = ArrowBytesForBits(bitmap->size_bits);
+}
+
+/// \brief Append a single bit to a bitmap, reserving space if required
+static inline ArrowErrorCode ArrowBitmapAppendBit(struct ArrowBitmap* bitmap,
+                                                  uint8_t bit_is_set) {
+  if (bitmap->size_bits >= (bitmap->buffer.capacity_bytes * 8)) {
+    int result = ArrowBitmapReserve(bitmap, 1);
+    if (result != NANOARROW_OK) {
+      return result;
+    }
+  }
+
+  ArrowBitmapAppendBitUnsafe(bitmap, bit_is_set);
+  return NANOARROW_OK;
+}
+
+/// }@
+
+/// \defgroup nanoarrow-array Array producer helpers
+///
+/// These functions allocate and destroy ArrowArray structures whose buffers are
+/// struct ArrowBuffer instances owned by the array's private_data. Buffers are
+/// built in place using the buffer and bitmap helpers and are exported without
+/// copying when the array is finished.
+
+/// \brief Initialize the fields of an array
+///
+/// Initializes the fields and release callback of array and sets
+/// array->n_buffers to the number of buffers required by storage_type.
+/// Returns EINVAL for storage types that do not have a fixed buffer layout
+/// (e.g., NANOARROW_TYPE_DICTIONARY). Caller is responsible for calling the
+/// array->release callback if NANOARROW_OK is returned.
+ArrowErrorCode ArrowArrayInit(struct ArrowArray* array, enum ArrowType storage_type);
+
+/// \brief Allocate the array->children array
+///
+/// Includes the memory for each child struct ArrowArray, which is
+/// allocated in the same block as the array of pointers. Children are
+/// uninitialized (i.e., their release callback is NULL). array must have
+/// been allocated using ArrowArrayInit.
+ArrowErrorCode ArrowArrayAllocateChildren(struct ArrowArray* array, int64_t n_children);
+
+/// \brief Allocate the array->dictionary member
+///
+/// array must have been allocated using ArrowArrayInit.
+ArrowErrorCode ArrowArrayAllocateDictionary(struct ArrowArray* array);
+
+/// \brief Access a buffer of an array for building
+///
+/// Returns the struct ArrowBuffer that will become array->buffers[i] or NULL
+/// if array was not allocated using ArrowArrayInit or i is out of range.
+/// The buffer remains owned by the array.
+struct ArrowBuffer* ArrowArrayBuffer(struct ArrowArray* array, int64_t i);
+
+/// \brief Transfer ownership of a buffer to an array
+///
+/// Releases the current content of array buffer i and moves buffer into its
+/// place, leaving buffer empty. Buffers that wrap memory owned elsewhere (e.g.,
+/// using ArrowBufferInitWrap()) are transferred without copying. Returns
+/// EINVAL if array was not allocated using ArrowArrayInit or i is out of range.
+ArrowErrorCode ArrowArraySetBuffer(struct ArrowArray* array, int64_t i,
+                                   struct ArrowBuffer* buffer);
+
+/// \brief Finish building an array
+///
+/// Updates array->buffers to point to the current content of each buffer for
+/// array and (recursively) any children or dictionary that were allocated
+/// using ArrowArrayInit. Empty buffers other than the validity buffer are
+/// exported as a non-NULL pointer. The caller is responsible for setting
+/// array->length, array->null_count, and array->offset. Must be called again
+/// if any buffer is modified afterwards.
+ArrowErrorCode ArrowArrayFinishBuilding(struct ArrowArray* array,
+                                        struct ArrowError* error);
+
+/// }@
+
+/// \defgroup nanoarrow-encoding Lightweight buffer encodings
+///
+/// Dependency-free encodings for buffers of fixed-width values that compress
+/// well without a general-purpose compressor. Values are value_size bytes wide
+/// (1, 2, 4, or 8) in native byte order; encoded buffers are little-endian
+/// regardless of platform so that they can be decoded elsewhere. Encoders and
+/// decoders append to out; on error, out is truncated to its original size.
+/// Encoders return EINVAL for an unsupported value_size or a values buffer
+/// whose size is not a multiple of it; decoders return EINVAL for a malformed
+/// (e.g., truncated) encoded buffer.
+
+/// \brief Run-length encode a buffer
+///
+/// Writes the number of values followed by each run of identical values as a
+/// 32-bit run length and the value. Values are compared bit for bit, so any
+/// fixed-width type (including floating point) can be run-length encoded.
+ArrowErrorCode ArrowBufferEncodeRunLength(struct ArrowBufferView values,
+                                          int64_t value_size, struct ArrowBuffer* out);
+
+/// \brief Decode a run-length encoded buffer
+ArrowErrorCode ArrowBufferDecodeRunLength(struct ArrowBufferView encoded,
+                                          int64_t value_size, struct ArrowBuffer* out);
+
+/// \brief Frame-of-reference encode a buffer of signed integers
+///
+/// Splits the values into blocks of 128 and writes each block as its minimum
+/// followed by the difference between each value and that minimum, bit-packed
+/// using as many bits as the largest difference in the block requires.
+ArrowErrorCode ArrowBufferEncodeFrameOfReference(struct ArrowBufferView values,
+                                                 int64_t value_size,
+                                                 struct ArrowBuffer* out);
+
+/// \brief Decode a frame-of-reference encoded buffer
+ArrowErrorCode ArrowBufferDecodeFrameOfReference(struct ArrowBufferView encoded,
+                                                 int64_t value_size,
+                                                 struct ArrowBuffer* out);
+
+/// \brief Delta encode a buffer of signed integers
+///
+/// Writes the first value followed by the frame-of-reference encoded
+/// differences between consecutive values, which makes sorted or slowly
+/// changing columns (e.g., timestamps) very small. Differences wrap around
+/// rather than overflow, so any values round trip.
+ArrowErrorCode ArrowBufferEncodeDelta(struct ArrowBufferView values, int64_t value_size,
+                                      struct ArrowBuffer* out);
+
+/// \brief Decode a delta encoded buffer
+ArrowErrorCode ArrowBufferDecodeDelta(struct ArrowBufferView encoded, int64_t value_size,
+                                      struct ArrowBuffer* out);
+
+/// }@
+
+/// \defgroup nanoarrow-endian Byte order utilities
+///
+/// Kernels that reverse the byte order of fixed-width values, e.g., to import
+/// buffers produced on a platform with the opposite endianness. Values are
+/// value_size bytes wide (2, 4, 8, 16, or 32); 16- and 32-byte values are
+/// reversed as a whole, as is required for decimal128 and decimal256 values.
+/// These functions return EINVAL for any other value_size.
+
+/// \brief Reverse the byte order of n_values values
+///
+/// out and values may be identical to swap in place but must not otherwise
+/// overlap.
+ArrowErrorCode ArrowByteSwap(void* out, const void* values, int64_t n_values,
+                             int64_t value_size);
+
+/// \brief Reverse the byte order of every value in a buffer in place
+///
+/// Returns EINVAL if the size of the buffer is not a multiple of value_size.
+ArrowErrorCode ArrowBufferByteSwap(struct ArrowBuffer* buffer, int64_t value_size);
+
+/// \brief Append values to a buffer with their byte order reversed
+///
+/// Returns EINVAL if the size of values is not a multiple of value_size.
+ArrowErrorCode ArrowBufferAppendByteSwapped(struct ArrowBuffer* buffer,
+                                            struct ArrowBufferView values,
+                                            int64_t value_size);
+
+/// \brief Reverse the byte order of an array's buffers in place
+///
+/// Uses the buffer layout described by the ArrowSchemaView of schema to swap
+/// the offsets and fixed-width data of array, its children and its dictionary.
+/// Validity bitmaps, type ids and variable-length data have no byte order and
+/// are left as is. The array's buffers must be writable. Returns EINVAL
+/// without modifying array if its structure does not match schema.
+ArrowErrorCode ArrowArrayByteSwap(struct ArrowArray* array, struct ArrowSchema* schema,
+                                  struct ArrowError* error);
+
+/// }@
+
+/// \defgroup nanoarrow-take Gather and scatter kernels
+///
+/// Kernels that reorder fixed-width values by an index vector, e.g., to apply
+/// the result of a sort or a join. Values are value_size bytes wide (1, 2, 4, 8,
+/// or 16) and indices are int32_t or int64_t as given by index_size (4 or 8).
+/// These functions return EINVAL for any other value_size or index_size, for
+/// buffers whose size is not a multiple of them, or for an index that is out of
+/// bounds, leaving out unchanged.
+
+/// \brief Append values[indices[i]] to out for each index
+ArrowErrorCode ArrowBufferTake(struct ArrowBufferView values, int64_t value_size,
+                               struct ArrowBufferView indices, int64_t index_size,
+                               struct ArrowBuffer* out);
+
+/// \brief Write values[i] to position indices[i] of out for each index
+///
+/// out must already be large enough to hold every position that is written
+/// and values must have one value per index. If an index appears more than
+/// once, the value written last wins.
+ArrowErrorCode ArrowBufferScatter(struct ArrowBufferView values, int64_t value_size,
+                                  struct ArrowBufferView indices, int64_t index_size,
+                                  struct ArrowBuffer* out);
+
+/// \brief Append the bits at i_from + indices[i] of a bitmap to an ArrowBitmap
+///
+/// Gathers the validity bits that go with the values gathered by
+/// ArrowBufferTake(). Indices must be less than length. If bits is NULL
+/// (i.e., all values are valid), set bits are appended.
+ArrowErrorCode ArrowBitmapTake(struct ArrowBitmap* bitmap, const uint8_t* bits,
+                               int64_t i_from, int64_t length,
+                               struct ArrowBufferView indices, int64_t index_size);
+
+/// }@
+
+/// \defgroup nanoarrow-hash Hashing and comparison
+///
+/// Fast non-cryptographic hashing and equality of buffer contents, e.g., to
+/// cache dictionaries or batches by content. Hashes are suitable for hash
+/// tables and cache keys but not for protecting against deliberate collisions.
+
+/// \brief Compute a 64-bit hash of size_bytes bytes
+///
+/// Implements the 64-bit variant of XXH3 with a seed (XXH3_64bits_withSeed()),
+/// so the result is identical to that of other XXH3 implementations and is the
+/// same on every platform. Large inputs are hashed close to memory bandwidth
+/// when compiled with AVX2 or SSE2.
+uint64_t ArrowHash64(const void* data, int64_t size_bytes, uint64_t seed);
+
+/// \brief Compute a 64-bit hash of the contents of a buffer
+///
+/// Equivalent to ArrowHash64(buffer->data, buffer->size_bytes, seed); the
+/// capacity of the buffer beyond its size does not contribute to the hash.
+uint64_t ArrowBufferHash(const struct ArrowBuffer* buffer, uint64_t seed);
+
+/// \brief Return non-zero if two byte ranges have the same size and contents
+char ArrowBufferViewEqual(struct ArrowBufferView lhs, struct ArrowBufferView rhs);
+
+/// \brief Return non-zero if two buffers have the same size and contents
+char ArrowBufferEqual(const struct ArrowBuffer* lhs, const struct ArrowBuffer* rhs);
+
 /// }@
 
 #ifdef __cplusplus
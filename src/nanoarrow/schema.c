@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "atomic_internal.h"
 #include "nanoarrow.h"
 
 void ArrowSchemaRelease(struct ArrowSchema* schema) {
@@ -29,15 +30,12 @@ void ArrowSchemaRelease(struct ArrowSchema* schema) {
 
   // This object owns the memory for all the children, but those
   // children may have been generated elsewhere and might have
-  // their own release() callback.
+  // their own release() callback. The child structs are allocated
+  // in the same block as the children array.
   if (schema->children != NULL) {
     for (int64_t i = 0; i < schema->n_children; i++) {
-      if (schema->children[i] != NULL) {
-        if (schema->children[i]->release != NULL) {
-          schema->children[i]->release(schema->children[i]);
-        }
-
-        ArrowFree(schema->children[i]);
+      if (schema->children[i] != NULL && schema->children[i]->release != NULL) {
+        schema->children[i]->release(schema->children[i]);
       }
     }
 
@@ -379,8 +377,9 @@ ArrowErrorCode ArrowSchemaAllocateChildren(struct ArrowSchema* schema,
   }
 
   if (n_children > 0) {
-    schema->children =
-        (struct ArrowSchema**)ArrowMalloc(n_children * sizeof(struct ArrowSchema*));
+    // Allocate the array of pointers and the child structs in one block
+    schema->children = (struct ArrowSchema**)ArrowMalloc(
+        n_children * (sizeof(struct ArrowSchema*) + sizeof(struct ArrowSchema)));
 
     if (schema->children == NULL) {
       return ENOMEM;
@@ -388,15 +387,10 @@ ArrowErrorCode ArrowSchemaAllocateChildren(struct ArrowSchema* schema,
 
     schema->n_children = n_children;
 
-    memset(schema->children, 0, n_children * sizeof(struct ArrowSchema*));
-
+    struct ArrowSchema* child_structs =
+        (struct ArrowSchema*)(schema->children + n_children);
     for (int64_t i = 0; i < n_children; i++) {
-      schema->children[i] = (struct ArrowSchema*)ArrowMalloc(sizeof(struct ArrowSchema));
-
-      if (schema->children[i] == NULL) {
-        return ENOMEM;
-      }
-
+      schema->children[i] = child_structs + i;
       schema->children[i]->release = NULL;
     }
   }
@@ -473,3 +467,136 @@ int ArrowSchemaDeepCopy(struct ArrowSchema* schema, struct ArrowSchema* schema_o
 
   return NANOARROW_OK;
 }
+
+// A compact copy places every node's children array, child structs,
+// dictionary struct, and strings in a single allocation that starts with a
+// reference count. Each node with a release callback holds one reference so
+// that a child moved out of its parent keeps the block alive after the parent
+// has been released.
+struct ArrowSchemaCompactBlock {
+  int64_t ref_count;
+  int64_t padding;
+};
+
+struct ArrowSchemaCompactLayout {
+  int64_t n_nodes;
+  int64_t struct_bytes;
+  int64_t string_bytes;
+  uint8_t* struct_cursor;
+  char* string_cursor;
+};
+
+static void ArrowSchemaReleaseCompact(struct ArrowSchema* schema) {
+  for (int64_t i = 0; i < schema->n_children; i++) {
+    if (schema->children[i]->release != NULL) {
+      schema->children[i]->release(schema->children[i]);
+    }
+  }
+
+  if (schema->dictionary != NULL && schema->dictionary->release != NULL) {
+    schema->dictionary->release(schema->dictionary);
+  }
+
+  struct ArrowSchemaCompactBlock* block =
+      (struct ArrowSchemaCompactBlock*)schema->private_data;
+  if (ArrowAtomicAdd(&block->ref_count, -1) == 0) {
+    ArrowFree(block);
+  }
+
+  schema->release = NULL;
+}
+
+static int64_t ArrowSchemaCompactStringSize(const char* value) {
+  return value == NULL ? 0 : (int64_t)strlen(value) + 1;
+}
+
+static void ArrowSchemaCompactMeasure(struct ArrowSchema* schema,
+                                      struct ArrowSchemaCompactLayout* layout) {
+  layout->n_nodes++;
+  layout->string_bytes += ArrowSchemaCompactStringSize(schema->format);
+  layout->string_bytes += ArrowSchemaCompactStringSize(schema->name);
+  if (schema->metadata != NULL) {
+    layout->string_bytes += ArrowMetadataSizeOf(schema->metadata);
+  }
+
+  layout->struct_bytes +=
+      schema->n_children * (sizeof(struct ArrowSchema*) + sizeof(struct ArrowSchema));
+  for (int64_t i = 0; i < schema->n_children; i++) {
+    ArrowSchemaCompactMeasure(schema->children[i], layout);
+  }
+
+  if (schema->dictionary != NULL) {
+    layout->struct_bytes += sizeof(struct ArrowSchema);
+    ArrowSchemaCompactMeasure(schema->dictionary, layout);
+  }
+}
+
+static const char* ArrowSchemaCompactCopyString(struct ArrowSchemaCompactLayout* layout,
+                                                const char* value, int64_t size) {
+  if (value == NULL) {
+    return NULL;
+  }
+
+  char* out = layout->string_cursor;
+  memcpy(out, value, size);
+  layout->string_cursor += size;
+  return out;
+}
+
+static void ArrowSchemaCompactCopy(struct ArrowSchema* schema,
+                                   struct ArrowSchema* schema_out,
+                                   struct ArrowSchemaCompactBlock* block,
+                                   struct ArrowSchemaCompactLayout* layout) {
+  schema_out->format = ArrowSchemaCompactCopyString(
+      layout, schema->format, ArrowSchemaCompactStringSize(schema->format));
+  schema_out->name = ArrowSchemaCompactCopyString(
+      layout, schema->name, ArrowSchemaCompactStringSize(schema->name));
+  schema_out->metadata = ArrowSchemaCompactCopyString(
+      layout, schema->metadata,
+      schema->metadata == NULL ? 0 : ArrowMetadataSizeOf(schema->metadata));
+  schema_out->flags = schema->flags;
+  schema_out->n_children = schema->n_children;
+  schema_out->children = NULL;
+  schema_out->dictionary = NULL;
+  schema_out->private_data = block;
+  schema_out->release = &ArrowSchemaReleaseCompact;
+
+  if (schema->n_children > 0) {
+    schema_out->children = (struct ArrowSchema**)layout->struct_cursor;
+    struct ArrowSchema* child_structs =
+        (struct ArrowSchema*)(schema_out->children + schema->n_children);
+    layout->struct_cursor +=
+        schema->n_children * (sizeof(struct ArrowSchema*) + sizeof(struct ArrowSchema));
+
+    for (int64_t i = 0; i < schema->n_children; i++) {
+      schema_out->children[i] = child_structs + i;
+      ArrowSchemaCompactCopy(schema->children[i], schema_out->children[i], block,
+                             layout);
+    }
+  }
+
+  if (schema->dictionary != NULL) {
+    schema_out->dictionary = (struct ArrowSchema*)layout->struct_cursor;
+    layout->struct_cursor += sizeof(struct ArrowSchema);
+    ArrowSchemaCompactCopy(schema->dictionary, schema_out->dictionary, block, layout);
+  }
+}
+
+ArrowErrorCode ArrowSchemaDeepCopyCompact(struct ArrowSchema* schema,
+                                          struct ArrowSchema* schema_out) {
+  struct ArrowSchemaCompactLayout layout;
+  memset(&layout, 0, sizeof(struct ArrowSchemaCompactLayout));
+  ArrowSchemaCompactMeasure(schema, &layout);
+
+  struct ArrowSchemaCompactBlock* block = (struct ArrowSchemaCompactBlock*)ArrowMalloc(
+      sizeof(struct ArrowSchemaCompactBlock) + layout.struct_bytes + layout.string_bytes);
+  if (block == NULL) {
+    return ENOMEM;
+  }
+
+  block->ref_count = layout.n_nodes;
+  layout.struct_cursor = (uint8_t*)(block + 1);
+  layout.string_cursor = (char*)(layout.struct_cursor + layout.struct_bytes);
+  ArrowSchemaCompactCopy(schema, schema_out, block, &layout);
+  return NANOARROW_OK;
+}
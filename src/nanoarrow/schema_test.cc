@@ -15,6 +15,9 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <cstring>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include <arrow/c/bridge.h>
@@ -415,3 +418,112 @@ TEST(SchemaTest, SchemaCopyMetadata) {
 
   schema.release(&schema);
 }
+
+TEST(SchemaTest, SchemaAllocateChildrenSingleBlock) {
+  struct ArrowSchema schema;
+  ASSERT_EQ(ArrowSchemaInit(&schema, NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(&schema, 3), NANOARROW_OK);
+  EXPECT_EQ(ArrowSchemaAllocateChildren(&schema, 3), EEXIST);
+
+  // The child structs are contiguous and follow the array of pointers
+  EXPECT_EQ(reinterpret_cast<uint8_t*>(schema.children[0]),
+            reinterpret_cast<uint8_t*>(schema.children + 3));
+  EXPECT_EQ(schema.children[1], schema.children[0] + 1);
+  EXPECT_EQ(schema.children[2], schema.children[0] + 2);
+
+  // Children can be left uninitialized, initialized, or moved out
+  ASSERT_EQ(ArrowSchemaInit(schema.children[0], NANOARROW_TYPE_INT32), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[1], NANOARROW_TYPE_STRING), NANOARROW_OK);
+  struct ArrowSchema moved;
+  memcpy(&moved, schema.children[1], sizeof(struct ArrowSchema));
+  schema.children[1]->release = nullptr;
+
+  schema.release(&schema);
+  EXPECT_STREQ(moved.format, "u");
+  moved.release(&moved);
+}
+
+static void MakeWideSchema(struct ArrowSchema* schema, int64_t n_children) {
+  ASSERT_EQ(ArrowSchemaInit(schema, NANOARROW_TYPE_STRUCT), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaSetName(schema, "root"), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateChildren(schema, n_children), NANOARROW_OK);
+  for (int64_t i = 0; i < n_children; i++) {
+    ASSERT_EQ(ArrowSchemaInit(schema->children[i], NANOARROW_TYPE_INT32), NANOARROW_OK);
+    std::string name = "col" + std::to_string(i);
+    ASSERT_EQ(ArrowSchemaSetName(schema->children[i], name.c_str()), NANOARROW_OK);
+  }
+}
+
+TEST(SchemaTest, SchemaCopyCompact) {
+  struct ArrowSchema schema;
+  MakeWideSchema(&schema, 2000);
+
+  // Give one child metadata and a dictionary
+  const char metadata[] = {1, 0, 0, 0, 3, 0, 0, 0, 'k', 'e', 'y', 5, 0, 0, 0,
+                           'v', 'a', 'l', 'u', 'e'};
+  ASSERT_EQ(ArrowSchemaSetMetadata(schema.children[5], metadata), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaAllocateDictionary(schema.children[5]), NANOARROW_OK);
+  ASSERT_EQ(ArrowSchemaInit(schema.children[5]->dictionary, NANOARROW_TYPE_STRING),
+            NANOARROW_OK);
+
+  struct ArrowSchema schema_copy;
+  ASSERT_EQ(ArrowSchemaDeepCopyCompact(&schema, &schema_copy), NANOARROW_OK);
+  schema.release(&schema);
+
+  ASSERT_NE(schema_copy.release, nullptr);
+  EXPECT_STREQ(schema_copy.format, "+s");
+  EXPECT_STREQ(schema_copy.name, "root");
+  EXPECT_EQ(schema_copy.metadata, nullptr);
+  EXPECT_EQ(schema_copy.flags, ARROW_FLAG_NULLABLE);
+  ASSERT_EQ(schema_copy.n_children, 2000);
+  EXPECT_STREQ(schema_copy.children[0]->format, "i");
+  EXPECT_STREQ(schema_copy.children[1999]->name, "col1999");
+  EXPECT_EQ(schema_copy.children[0]->n_children, 0);
+  EXPECT_EQ(schema_copy.children[0]->dictionary, nullptr);
+
+  struct ArrowStringView value;
+  ASSERT_EQ(ArrowMetadataGetValue(schema_copy.children[5]->metadata, "key", nullptr,
+                                  &value),
+            NANOARROW_OK);
+  EXPECT_EQ(std::string(value.data, value.n_bytes), "value");
+  ASSERT_NE(schema_copy.children[5]->dictionary, nullptr);
+  EXPECT_STREQ(schema_copy.children[5]->dictionary->format, "u");
+
+  // Move a child out and release the parent first
+  struct ArrowSchema moved;
+  memcpy(&moved, schema_copy.children[5], sizeof(struct ArrowSchema));
+  schema_copy.children[5]->release = nullptr;
+
+  schema_copy.release(&schema_copy);
+  EXPECT_EQ(schema_copy.release, nullptr);
+  EXPECT_STREQ(moved.name, "col5");
+  EXPECT_STREQ(moved.dictionary->format, "u");
+  moved.release(&moved);
+  EXPECT_EQ(moved.release, nullptr);
+}
+
+TEST(SchemaTest, SchemaCopyCompactAllocations) {
+  struct ArrowSchema schema;
+  MakeWideSchema(&schema, 2000);
+
+  struct ArrowBufferAllocator allocator;
+  ASSERT_EQ(ArrowBufferAllocatorStatsInit(&allocator, ArrowBufferAllocatorDefault()),
+            NANOARROW_OK);
+
+  // Count allocations made by ArrowMalloc() while copying
+  struct ArrowSchema schema_copy;
+  ArrowMallocSetAllocator(&allocator);
+  ASSERT_EQ(ArrowSchemaDeepCopyCompact(&schema, &schema_copy), NANOARROW_OK);
+  struct ArrowBufferAllocatorStats stats;
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.n_allocations, 1);
+  schema_copy.release(&schema_copy);
+  ArrowMallocSetAllocator(nullptr);
+
+  ArrowBufferAllocatorStatsGet(&allocator, &stats);
+  EXPECT_EQ(stats.n_frees, 1);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+
+  ArrowBufferAllocatorStatsRelease(&allocator);
+  schema.release(&schema);
+}
@@ -244,11 +244,14 @@ static ArrowErrorCode ArrowSchemaViewParse(struct ArrowSchemaView* schema_view,
           schema_view->validity_buffer_id = 0;
           *format_end_out = format + 2;
           return NANOARROW_OK;
+
+        // map has the same layout as a list
         case 'm':
           schema_view->storage_data_type = NANOARROW_TYPE_MAP;
           schema_view->data_type = NANOARROW_TYPE_MAP;
-          schema_view->n_buffers = 1;
+          schema_view->n_buffers = 2;
           schema_view->validity_buffer_id = 0;
+          schema_view->offset_buffer_id = 1;
           *format_end_out = format + 2;
           return NANOARROW_OK;
 
@@ -629,8 +629,9 @@ TEST(SchemaViewTest, SchemaViewInitNestedMap) {
 
   ARROW_EXPECT_OK(ExportType(*map(int32(), int32()), &schema));
   EXPECT_EQ(ArrowSchemaViewInit(&schema_view, &schema, &error), NANOARROW_OK);
-  EXPECT_EQ(schema_view.n_buffers, 1);
+  EXPECT_EQ(schema_view.n_buffers, 2);
   EXPECT_EQ(schema_view.validity_buffer_id, 0);
+  EXPECT_EQ(schema_view.offset_buffer_id, 1);
   EXPECT_EQ(schema_view.data_type, NANOARROW_TYPE_MAP);
   EXPECT_EQ(schema_view.storage_data_type, NANOARROW_TYPE_MAP);
   schema.release(&schema);
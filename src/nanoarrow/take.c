@@ -0,0 +1,369 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <errno.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "nanoarrow.h"
+
+// Gather instructions are only faster than scalar loads when the values are
+// in cache; when most loads miss, the scalar loop keeps more of them in flight
+#define NANOARROW_TAKE_GATHER_MAX_BYTES (1024 * 1024)
+
+static int ArrowTakeValidSizes(struct ArrowBufferView values, int64_t value_size,
+                               struct ArrowBufferView indices, int64_t index_size) {
+  if (value_size != 1 && value_size != 2 && value_size != 4 && value_size != 8 &&
+      value_size != 16) {
+    return 0;
+  }
+
+  if (index_size != 4 && index_size != 8) {
+    return 0;
+  }
+
+  return (values.size_bytes % value_size) == 0 && (indices.size_bytes % index_size) == 0;
+}
+
+static inline int64_t ArrowTakeIndex(const uint8_t* indices, int64_t i,
+                                     int64_t index_size) {
+  if (index_size == 4) {
+    int32_t index;
+    memcpy(&index, indices + i * 4, sizeof(int32_t));
+    return index;
+  } else {
+    int64_t index;
+    memcpy(&index, indices + i * 8, sizeof(int64_t));
+    return index;
+  }
+}
+
+// Negative indices are out of bounds as well because they compare as very
+// large unsigned values
+static int ArrowTakeIndicesInBounds(const uint8_t* indices, int64_t n_indices,
+                                    int64_t index_size, int64_t n_values) {
+  int out_of_bounds = 0;
+  if (index_size == 4) {
+    for (int64_t i = 0; i < n_indices; i++) {
+      out_of_bounds |= (uint64_t)ArrowTakeIndex(indices, i, 4) >= (uint64_t)n_values;
+    }
+  } else {
+    for (int64_t i = 0; i < n_indices; i++) {
+      out_of_bounds |= (uint64_t)ArrowTakeIndex(indices, i, 8) >= (uint64_t)n_values;
+    }
+  }
+
+  return !out_of_bounds;
+}
+
+// Called with constant value_size and index_size so that each call is
+// compiled into a loop of fixed-size loads and stores. Out of bounds indices
+// are checked in the same pass: they are replaced with zero so that nothing
+// is read out of bounds, and the caller discards the output if any were found.
+static inline int ArrowTakeLoop(uint8_t* out, const uint8_t* values,
+                                const uint8_t* indices, int64_t n_indices,
+                                int64_t n_values, int64_t value_size,
+                                int64_t index_size) {
+  int out_of_bounds = 0;
+  for (int64_t i = 0; i < n_indices; i++) {
+    int64_t index = ArrowTakeIndex(indices, i, index_size);
+    int index_out_of_bounds = (uint64_t)index >= (uint64_t)n_values;
+    out_of_bounds |= index_out_of_bounds;
+    index = index_out_of_bounds ? 0 : index;
+    memcpy(out + i * value_size, values + index * value_size, value_size);
+  }
+
+  return out_of_bounds;
+}
+
+// Scattering writes to memory that the caller owns, so indices are checked
+// before this is called
+static inline void ArrowScatterLoop(uint8_t* out, const uint8_t* values,
+                                    const uint8_t* indices, int64_t n_indices,
+                                    int64_t value_size, int64_t index_size) {
+  for (int64_t i = 0; i < n_indices; i++) {
+    memcpy(out + ArrowTakeIndex(indices, i, index_size) * value_size,
+           values + i * value_size, value_size);
+  }
+}
+
+#if defined(__AVX2__)
+
+// Takes 4- and 8-byte values eight or four at a time using gather
+// instructions and returns the number of values taken. Like ArrowTakeLoop(),
+// out of bounds indices are replaced with zero and reported.
+static int64_t ArrowTakeGather(uint8_t* out, const uint8_t* values,
+                               const uint8_t* indices, int64_t n_indices,
+                               int64_t n_values, int64_t value_size,
+                               int64_t index_size, int* out_of_bounds) {
+  int64_t i = 0;
+  if (index_size == 4 && (value_size == 4 || value_size == 8)) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i max_index =
+        _mm256_set1_epi32(n_values > INT32_MAX ? INT32_MAX : (int32_t)(n_values - 1));
+    __m256i any_out_of_bounds = zero;
+    if (value_size == 4) {
+      for (; i + 8 <= n_indices; i += 8) {
+        __m256i index = _mm256_loadu_si256((const __m256i*)(indices + i * 4));
+        __m256i index_out_of_bounds = _mm256_or_si256(
+            _mm256_cmpgt_epi32(zero, index), _mm256_cmpgt_epi32(index, max_index));
+        any_out_of_bounds = _mm256_or_si256(any_out_of_bounds, index_out_of_bounds);
+        index = _mm256_andnot_si256(index_out_of_bounds, index);
+        __m256i value = _mm256_i32gather_epi32((const int*)values, index, 4);
+        _mm256_storeu_si256((__m256i*)(out + i * 4), value);
+      }
+    } else {
+      for (; i + 8 <= n_indices; i += 8) {
+        __m256i index = _mm256_loadu_si256((const __m256i*)(indices + i * 4));
+        __m256i index_out_of_bounds = _mm256_or_si256(
+            _mm256_cmpgt_epi32(zero, index), _mm256_cmpgt_epi32(index, max_index));
+        any_out_of_bounds = _mm256_or_si256(any_out_of_bounds, index_out_of_bounds);
+        index = _mm256_andnot_si256(index_out_of_bounds, index);
+        __m256i lo = _mm256_i32gather_epi64((const long long*)values,
+                                            _mm256_castsi256_si128(index), 8);
+        __m256i hi = _mm256_i32gather_epi64((const long long*)values,
+                                            _mm256_extracti128_si256(index, 1), 8);
+        _mm256_storeu_si256((__m256i*)(out + i * 8), lo);
+        _mm256_storeu_si256((__m256i*)(out + i * 8 + 32), hi);
+      }
+    }
+
+    *out_of_bounds |= !_mm256_testz_si256(any_out_of_bounds, any_out_of_bounds);
+  } else if (index_size == 8 && (value_size == 4 || value_size == 8)) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i max_index = _mm256_set1_epi64x(n_values - 1);
+    __m256i any_out_of_bounds = zero;
+    for (; i + 4 <= n_indices; i += 4) {
+      __m256i index = _mm256_loadu_si256((const __m256i*)(indices + i * 8));
+      __m256i index_out_of_bounds = _mm256_or_si256(
+          _mm256_cmpgt_epi64(zero, index), _mm256_cmpgt_epi64(index, max_index));
+      any_out_of_bounds = _mm256_or_si256(any_out_of_bounds, index_out_of_bounds);
+      index = _mm256_andnot_si256(index_out_of_bounds, index);
+      if (value_size == 4) {
+        __m128i value = _mm256_i64gather_epi32((const int*)values, index, 4);
+        _mm_storeu_si128((__m128i*)(out + i * 4), value);
+      } else {
+        __m256i value = _mm256_i64gather_epi64((const long long*)values, index, 8);
+        _mm256_storeu_si256((__m256i*)(out + i * 8), value);
+      }
+    }
+
+    *out_of_bounds |= !_mm256_testz_si256(any_out_of_bounds, any_out_of_bounds);
+  }
+
+  return i;
+}
+
+#else
+
+static int64_t ArrowTakeGather(uint8_t* out, const uint8_t* values,
+                               const uint8_t* indices, int64_t n_indices,
+                               int64_t n_values, int64_t value_size,
+                               int64_t index_size, int* out_of_bounds) {
+  return 0;
+}
+
+#endif
+
+static int ArrowTakeDispatch(uint8_t* out, const uint8_t* values, const uint8_t* indices,
+                             int64_t n_indices, int64_t n_values, int64_t value_size,
+                             int64_t index_size) {
+  int out_of_bounds = 0;
+  if (n_values * value_size <= NANOARROW_TAKE_GATHER_MAX_BYTES) {
+    int64_t n_taken = ArrowTakeGather(out, values, indices, n_indices, n_values,
+                                      value_size, index_size, &out_of_bounds);
+    out += n_taken * value_size;
+    indices += n_taken * index_size;
+    n_indices -= n_taken;
+  }
+
+  if (index_size == 4) {
+    switch (value_size) {
+      case 1:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 1, 4);
+        break;
+      case 2:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 2, 4);
+        break;
+      case 4:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 4, 4);
+        break;
+      case 8:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 8, 4);
+        break;
+      default:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 16, 4);
+        break;
+    }
+  } else {
+    switch (value_size) {
+      case 1:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 1, 8);
+        break;
+      case 2:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 2, 8);
+        break;
+      case 4:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 4, 8);
+        break;
+      case 8:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 8, 8);
+        break;
+      default:
+        out_of_bounds |= ArrowTakeLoop(out, values, indices, n_indices, n_values, 16, 8);
+        break;
+    }
+  }
+
+  return out_of_bounds;
+}
+
+static void ArrowScatterDispatch(uint8_t* out, const uint8_t* values,
+                                 const uint8_t* indices, int64_t n_indices,
+                                 int64_t value_size, int64_t index_size) {
+  if (index_size == 4) {
+    switch (value_size) {
+      case 1:
+        ArrowScatterLoop(out, values, indices, n_indices, 1, 4);
+        break;
+      case 2:
+        ArrowScatterLoop(out, values, indices, n_indices, 2, 4);
+        break;
+      case 4:
+        ArrowScatterLoop(out, values, indices, n_indices, 4, 4);
+        break;
+      case 8:
+        ArrowScatterLoop(out, values, indices, n_indices, 8, 4);
+        break;
+      default:
+        ArrowScatterLoop(out, values, indices, n_indices, 16, 4);
+        break;
+    }
+  } else {
+    switch (value_size) {
+      case 1:
+        ArrowScatterLoop(out, values, indices, n_indices, 1, 8);
+        break;
+      case 2:
+        ArrowScatterLoop(out, values, indices, n_indices, 2, 8);
+        break;
+      case 4:
+        ArrowScatterLoop(out, values, indices, n_indices, 4, 8);
+        break;
+      case 8:
+        ArrowScatterLoop(out, values, indices, n_indices, 8, 8);
+        break;
+      default:
+        ArrowScatterLoop(out, values, indices, n_indices, 16, 8);
+        break;
+    }
+  }
+}
+
+ArrowErrorCode ArrowBufferTake(struct ArrowBufferView values, int64_t value_size,
+                               struct ArrowBufferView indices, int64_t index_size,
+                               struct ArrowBuffer* out) {
+  if (!ArrowTakeValidSizes(values, value_size, indices, index_size)) {
+    return EINVAL;
+  }
+
+  int64_t n_values = values.size_bytes / value_size;
+  int64_t n_indices = indices.size_bytes / index_size;
+  if (n_indices == 0) {
+    return NANOARROW_OK;
+  } else if (n_values == 0) {
+    return EINVAL;
+  }
+
+  int result = ArrowBufferReserve(out, n_indices * value_size);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  // Values are written past the end of out before the indices are known to be
+  // valid, but out only grows if they are
+  if (ArrowTakeDispatch(out->data + out->size_bytes, (const uint8_t*)values.data,
+                        (const uint8_t*)indices.data, n_indices, n_values, value_size,
+                        index_size)) {
+    return EINVAL;
+  }
+
+  out->size_bytes += n_indices * value_size;
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowBufferScatter(struct ArrowBufferView values, int64_t value_size,
+                                  struct ArrowBufferView indices, int64_t index_size,
+                                  struct ArrowBuffer* out) {
+  if (!ArrowTakeValidSizes(values, value_size, indices, index_size) ||
+      (values.size_bytes / value_size) != (indices.size_bytes / index_size)) {
+    return EINVAL;
+  }
+
+  int64_t n_indices = indices.size_bytes / index_size;
+  if (!ArrowTakeIndicesInBounds((const uint8_t*)indices.data, n_indices, index_size,
+                                out->size_bytes / value_size)) {
+    return EINVAL;
+  }
+
+  ArrowScatterDispatch(out->data, (const uint8_t*)values.data,
+                       (const uint8_t*)indices.data, n_indices, value_size, index_size);
+  return NANOARROW_OK;
+}
+
+ArrowErrorCode ArrowBitmapTake(struct ArrowBitmap* bitmap, const uint8_t* bits,
+                               int64_t i_from, int64_t length,
+                               struct ArrowBufferView indices, int64_t index_size) {
+  if ((index_size != 4 && index_size != 8) || (indices.size_bytes % index_size) != 0) {
+    return EINVAL;
+  }
+
+  int64_t n_indices = indices.size_bytes / index_size;
+  if (!ArrowTakeIndicesInBounds((const uint8_t*)indices.data, n_indices, index_size,
+                                length)) {
+    return EINVAL;
+  }
+
+  int result = ArrowBitmapReserve(bitmap, n_indices);
+  if (result != NANOARROW_OK) {
+    return result;
+  }
+
+  if (bits == NULL) {
+    ArrowBitmapAppendUnsafe(bitmap, 1, n_indices);
+    return NANOARROW_OK;
+  }
+
+  // Gather a byte per bit into a small chunk and let the packing kernel
+  // write the bits and count the nulls
+  int8_t chunk[256];
+  const uint8_t* indices_data = (const uint8_t*)indices.data;
+  for (int64_t i = 0; i < n_indices; i += 256) {
+    int64_t chunk_length = n_indices - i < 256 ? n_indices - i : 256;
+    for (int64_t j = 0; j < chunk_length; j++) {
+      int64_t index = ArrowTakeIndex(indices_data, i + j, index_size);
+      chunk[j] = (int8_t)ArrowBitGet(bits, i_from + index);
+    }
+
+    ArrowBitmapAppendInt8Unsafe(bitmap, chunk, chunk_length);
+  }
+
+  return NANOARROW_OK;
+}
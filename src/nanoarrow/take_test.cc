@@ -0,0 +1,222 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nanoarrow/nanoarrow.h"
+
+// Takes every value_size from a values buffer of n_values values using
+// indices of type IndexType and checks the result one value at a time
+template <typename IndexType>
+static void ExpectTake(int64_t value_size, int64_t n_values,
+                       const std::vector<IndexType>& indices) {
+  std::vector<uint8_t> values(n_values * value_size);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = static_cast<uint8_t>(i * 13 + 5);
+  }
+
+  struct ArrowBuffer out;
+  ArrowBufferInit(&out);
+  ASSERT_EQ(ArrowBufferAppendUInt8(&out, 0xff), NANOARROW_OK);
+
+  struct ArrowBufferView values_view = {values.data(),
+                                        static_cast<int64_t>(values.size())};
+  struct ArrowBufferView indices_view = {
+      indices.data(), static_cast<int64_t>(indices.size() * sizeof(IndexType))};
+  ASSERT_EQ(
+      ArrowBufferTake(values_view, value_size, indices_view, sizeof(IndexType), &out),
+      NANOARROW_OK);
+
+  ASSERT_EQ(out.size_bytes, static_cast<int64_t>(1 + indices.size() * value_size));
+  EXPECT_EQ(out.data[0], 0xff);
+  for (size_t i = 0; i < indices.size(); i++) {
+    EXPECT_EQ(memcmp(out.data + 1 + i * value_size,
+                     values.data() + indices[i] * value_size, value_size),
+              0);
+  }
+
+  ArrowBufferReset(&out);
+}
+
+TEST(TakeTest, Take) {
+  for (int64_t value_size : {1, 2, 4, 8, 16}) {
+    // Lengths around the gather width, in and out of order
+    for (int n_indices = 0; n_indices < 20; n_indices++) {
+      std::vector<int32_t> indices32;
+      std::vector<int64_t> indices64;
+      for (int i = 0; i < n_indices; i++) {
+        indices32.push_back((i * 7) % 20);
+        indices64.push_back((i * 11) % 20);
+      }
+
+      ExpectTake(value_size, 20, indices32);
+      ExpectTake(value_size, 20, indices64);
+    }
+
+    // Large enough to prefetch
+    std::vector<int64_t> indices;
+    int64_t n_values = 2 * 1024 * 1024 / value_size;
+    for (int64_t i = 0; i < 1000; i++) {
+      indices.push_back((i * 104729) % n_values);
+    }
+
+    ExpectTake(value_size, n_values, indices);
+  }
+}
+
+TEST(TakeTest, TakeErrors) {
+  int32_t values[] = {1, 2, 3};
+  struct ArrowBufferView values_view = {values, sizeof(values)};
+  int32_t indices[] = {0, 3};
+  struct ArrowBufferView indices_view = {indices, sizeof(indices)};
+
+  struct ArrowBuffer out;
+  ArrowBufferInit(&out);
+
+  EXPECT_EQ(ArrowBufferTake(values_view, 4, indices_view, 4, &out), EINVAL);
+  indices[1] = -1;
+  EXPECT_EQ(ArrowBufferTake(values_view, 4, indices_view, 4, &out), EINVAL);
+  indices[1] = 2;
+  EXPECT_EQ(ArrowBufferTake(values_view, 3, indices_view, 4, &out), EINVAL);
+  EXPECT_EQ(ArrowBufferTake(values_view, 4, indices_view, 2, &out), EINVAL);
+  EXPECT_EQ(ArrowBufferTake(values_view, 8, indices_view, 4, &out), EINVAL);
+  indices_view.size_bytes = 7;
+  EXPECT_EQ(ArrowBufferTake(values_view, 4, indices_view, 4, &out), EINVAL);
+  EXPECT_EQ(out.size_bytes, 0);
+
+  // Out of bounds indices are found wherever they are in a long index vector
+  std::vector<int64_t> many_values(100);
+  std::vector<int32_t> many_indices32(20);
+  std::vector<int64_t> many_indices64(20);
+  for (int64_t value_size : {4, 8}) {
+    struct ArrowBufferView many_values_view = {many_values.data(), 100 * value_size};
+    for (int bad = 0; bad < 20; bad++) {
+      many_indices32[bad] = 100;
+      many_indices64[bad] = -1;
+      EXPECT_EQ(ArrowBufferTake(many_values_view, value_size,
+                                {many_indices32.data(), 20 * sizeof(int32_t)}, 4, &out),
+                EINVAL);
+      EXPECT_EQ(ArrowBufferTake(many_values_view, value_size,
+                                {many_indices64.data(), 20 * sizeof(int64_t)}, 8, &out),
+                EINVAL);
+      many_indices32[bad] = 0;
+      many_indices64[bad] = 0;
+    }
+  }
+  EXPECT_EQ(out.size_bytes, 0);
+
+  // Taking nothing from nothing is fine, but taking anything is not
+  EXPECT_EQ(ArrowBufferTake({nullptr, 0}, 4, {nullptr, 0}, 4, &out), NANOARROW_OK);
+  indices_view.size_bytes = sizeof(indices);
+  EXPECT_EQ(ArrowBufferTake({nullptr, 0}, 4, indices_view, 4, &out), EINVAL);
+
+  ArrowBufferReset(&out);
+}
+
+TEST(TakeTest, Scatter) {
+  int64_t values[] = {10, 20, 30, 40};
+  struct ArrowBufferView values_view = {values, sizeof(values)};
+  int32_t indices[] = {3, 0, 4, 0};
+  struct ArrowBufferView indices_view = {indices, sizeof(indices)};
+
+  struct ArrowBuffer out;
+  ArrowBufferInit(&out);
+  ASSERT_EQ(ArrowBufferAppendZeros(&out, 5 * sizeof(int64_t)), NANOARROW_OK);
+
+  ASSERT_EQ(ArrowBufferScatter(values_view, 8, indices_view, 4, &out), NANOARROW_OK);
+  const int64_t* out_values = reinterpret_cast<const int64_t*>(out.data);
+  EXPECT_EQ(out_values[0], 40);
+  EXPECT_EQ(out_values[1], 0);
+  EXPECT_EQ(out_values[2], 0);
+  EXPECT_EQ(out_values[3], 10);
+  EXPECT_EQ(out_values[4], 30);
+
+  // Scatter is the inverse of take for a permutation
+  std::vector<int64_t> permutation;
+  std::vector<int16_t> permuted;
+  for (int64_t i = 0; i < 1000; i++) {
+    permutation.push_back((i * 17) % 1000);
+    permuted.push_back(static_cast<int16_t>(permutation.back()));
+  }
+
+  struct ArrowBuffer scattered;
+  ArrowBufferInit(&scattered);
+  ASSERT_EQ(ArrowBufferAppendZeros(&scattered, 1000 * sizeof(int16_t)), NANOARROW_OK);
+  ASSERT_EQ(ArrowBufferScatter({permuted.data(), 1000 * sizeof(int16_t)}, 2,
+                               {permutation.data(), 1000 * sizeof(int64_t)}, 8,
+                               &scattered),
+            NANOARROW_OK);
+  const int16_t* scattered_values = reinterpret_cast<const int16_t*>(scattered.data);
+  for (int16_t i = 0; i < 1000; i++) {
+    EXPECT_EQ(scattered_values[i], i);
+  }
+  ArrowBufferReset(&scattered);
+
+  // Out of bounds or mismatched lengths write nothing
+  indices[2] = 5;
+  EXPECT_EQ(ArrowBufferScatter(values_view, 8, indices_view, 4, &out), EINVAL);
+  indices[2] = 4;
+  values_view.size_bytes = 3 * sizeof(int64_t);
+  EXPECT_EQ(ArrowBufferScatter(values_view, 8, indices_view, 4, &out), EINVAL);
+  EXPECT_EQ(out_values[4], 30);
+
+  ArrowBufferReset(&out);
+}
+
+TEST(TakeTest, BitmapTake) {
+  // 0b00110101 = bits 0, 2, 4 and 5 are set
+  uint8_t bits[] = {0x35, 0x00};
+  int64_t indices[] = {0, 1, 2, 3, 4, 9, 4, 0};
+  struct ArrowBufferView indices_view = {indices, sizeof(indices)};
+
+  struct ArrowBitmap bitmap;
+  ArrowBitmapInit(&bitmap);
+  ASSERT_EQ(ArrowBitmapAppend(&bitmap, 1, 3), NANOARROW_OK);
+
+  ASSERT_EQ(ArrowBitmapTake(&bitmap, bits, 1, 15, indices_view, 8), NANOARROW_OK);
+  EXPECT_EQ(bitmap.size_bits, 11);
+  EXPECT_EQ(bitmap.null_count, 4);
+  int8_t expected[] = {1, 1, 1, 0, 1, 0, 1, 1, 0, 1, 0};
+  for (int64_t i = 0; i < 11; i++) {
+    EXPECT_EQ(ArrowBitGet(bitmap.buffer.data, i), expected[i]) << i;
+  }
+
+  // A NULL bitmap is all valid
+  ASSERT_EQ(ArrowBitmapTake(&bitmap, nullptr, 0, 10, indices_view, 8), NANOARROW_OK);
+  EXPECT_EQ(bitmap.size_bits, 19);
+  EXPECT_EQ(bitmap.null_count, 4);
+
+  // Longer than the internal chunk
+  std::vector<int32_t> many(1000);
+  for (size_t i = 0; i < many.size(); i++) {
+    many[i] = static_cast<int32_t>(i % 8);
+  }
+  ASSERT_EQ(ArrowBitmapTake(&bitmap, bits, 0, 8, {many.data(), 4000}, 4),
+            NANOARROW_OK);
+  EXPECT_EQ(bitmap.size_bits, 1019);
+  EXPECT_EQ(bitmap.null_count, 4 + 500);
+
+  EXPECT_EQ(ArrowBitmapTake(&bitmap, bits, 1, 9, indices_view, 8), EINVAL);
+  EXPECT_EQ(ArrowBitmapTake(&bitmap, bits, 1, 15, indices_view, 2), EINVAL);
+  EXPECT_EQ(bitmap.size_bits, 1019);
+
+  ArrowBitmapReset(&bitmap);
+}